@@ -5,12 +5,14 @@
 #include "ModDynamicAHService.h"
 #include "ModDynamicAHBuy.h"
 #include "DynamicAHSetup.h"
+#include "DynamicAHTrace.h"
 
 #include "Chat.h"
 #include "ChatCommand.h"
 #include "Optional.h"
 #include "World.h"
 #include "GameTime.h"
+#include "Log.h"
 
 #include <algorithm>
 #include <string>
@@ -101,6 +103,12 @@ ChatCommandTable DynamicAHCommands::GetCommands() const
             {"defaults", HandleCapsDefaults, SEC_ADMINISTRATOR, Acore::ChatCommands::Console::Yes},
         };
 
+    static ChatCommandTable traceSub =
+        {
+            {"", HandleTraceShow, SEC_ADMINISTRATOR, Acore::ChatCommands::Console::Yes},
+            {"dump", HandleTraceDump, SEC_ADMINISTRATOR, Acore::ChatCommands::Console::Yes},
+        };
+
     static ChatCommandTable rootSub =
         {
             // world+loop
@@ -129,6 +137,11 @@ ChatCommandTable DynamicAHCommands::GetCommands() const
 
             // context controls
             {"context", HandleContext, SEC_ADMINISTRATOR, Acore::ChatCommands::Console::Yes},
+
+            // decision flight recorder
+            {"trace", traceSub},
+
+            // core decision pass (dry, counts only)
         };
 
     static ChatCommandTable table =
@@ -369,3 +382,40 @@ bool DynamicAHCommands::HandleContext(ChatHandler *handler, Optional<std::string
 {
     return ModDynamicAH::Service::Instance().CmdContext(handler, keyOpt, valOpt);
 }
+
+// trace: flight recorder state
+bool DynamicAHCommands::HandleTraceShow(ChatHandler *handler)
+{
+    using ModDynamicAH::FlightRecorder;
+    uint64 written = FlightRecorder::Written();
+    handler->PSendSysMessage("ModDynamicAH: trace enabled={} records={} (ring holds {})",
+                             FlightRecorder::Enabled() ? 1u : 0u,
+                             std::min<uint64>(written, FlightRecorder::kCapacity),
+                             uint64(FlightRecorder::kCapacity));
+    handler->PSendSysMessage("Usage: .dah trace dump [file name, written to the logs directory]");
+    return true;
+}
+
+// trace dump [file]: decode the ring to a text file (server working directory)
+bool DynamicAHCommands::HandleTraceDump(ChatHandler *handler, Optional<std::string> nameOpt)
+{
+    // A bare file name under the logs directory: the command must not reach arbitrary paths
+    std::string name = nameOpt ? *nameOpt : std::string("dah_trace.log");
+    if (name.empty() || name.find_first_of("/\\:") != std::string::npos || name.find("..") != std::string::npos)
+    {
+        handler->PSendSysMessage("ModDynamicAH: trace file must be a plain file name (no '/', '\\', ':' or '..')");
+        return true;
+    }
+
+    std::string path = sLog->GetLogsDir();
+    if (!path.empty() && path.back() != '/' && path.back() != '\\')
+        path += '/';
+    path += name;
+
+    int64 n = ModDynamicAH::FlightRecorder::DumpToFile(path);
+    if (n < 0)
+        handler->PSendSysMessage("ModDynamicAH: could not open {} for writing", path);
+    else
+        handler->PSendSysMessage("ModDynamicAH: wrote {} trace records to {}", n, path);
+    return true;
+}
@@ -27,4 +27,6 @@ public:
     static bool HandleCapsSetHouse(ChatHandler *handler, std::string which, uint32 value);
     static bool HandleCapsSetFamily(ChatHandler *handler, std::string famName, uint32 value);
     static bool HandleContext(ChatHandler *handler, Optional<std::string> keyOpt, Optional<uint32> valOpt);
+    static bool HandleTraceShow(ChatHandler *handler);
+    static bool HandleTraceDump(ChatHandler *handler, Optional<std::string> nameOpt);
 };
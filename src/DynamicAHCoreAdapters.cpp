@@ -0,0 +1,57 @@
+#include "DynamicAHCoreAdapters.h"
+#include "AuctionHouseMgr.h"
+#include "GameTime.h"
+
+namespace ModDynamicAH
+{
+
+    void IndexItemCatalog::ForEach(std::function<void(Core::ItemFacts const &)> const &fn) const
+    {
+        for (Core::ItemFacts const &f : Items().facts) // slots are in ascending item id
+            fn(f);
+    }
+
+    void LiveAuctionSource::Snapshot(std::vector<Core::AuctionFacts> &out)
+    {
+        out.clear();
+        for (Core::House house : Core::Houses)
+        {
+            AuctionHouseObject *ahObj = sAuctionMgr->GetAuctionsMapByHouseId(FromCore(house));
+            if (!ahObj)
+                continue;
+            for (auto const &kv : ahObj->GetAuctions())
+                if (kv.second)
+                    out.push_back(FactsOf(MakeAuctionRow(*kv.second)));
+        }
+    }
+
+    size_t LiveAuctionSource::ScanHouse(Core::House house, uint32_t afterId, size_t maxRows,
+                                        std::vector<Core::AuctionFacts> &out)
+    {
+        AuctionHouseObject *ahObj = sAuctionMgr->GetAuctionsMapByHouseId(FromCore(house));
+        if (!ahObj)
+            return 0;
+
+        size_t n = 0;
+        auto const &map = ahObj->GetAuctions();
+        for (auto it = map.upper_bound(afterId); it != map.end() && n < maxRows; ++it)
+        {
+            if (!it->second)
+                continue;
+            out.push_back(FactsOf(MakeAuctionRow(*it->second)));
+            ++n;
+        }
+        return n;
+    }
+
+    uint64_t GameClock::NowMs() const
+    {
+        return uint64_t(GameTime::GetGameTimeMS().count());
+    }
+
+    uint32_t GameClock::NowSec() const
+    {
+        return uint32_t(GameTime::GetGameTime().count());
+    }
+
+} // namespace ModDynamicAH
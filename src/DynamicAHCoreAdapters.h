@@ -0,0 +1,108 @@
+#pragma once
+
+#include "DynamicAHTypes.h"
+#include "DynamicAHItemIndex.h"
+#include "CoreBuy.h"
+#include "CoreInterfaces.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace ModDynamicAH
+{
+
+    static_assert(uint8(AuctionHouseId::Alliance) == uint8(Core::House::Alliance) &&
+                      uint8(AuctionHouseId::Horde) == uint8(Core::House::Horde) &&
+                      uint8(AuctionHouseId::Neutral) == uint8(Core::House::Neutral),
+                  "Core::House mirrors AuctionHouseId");
+
+    inline Core::House ToCore(AuctionHouseId house) { return static_cast<Core::House>(house); }
+    inline AuctionHouseId FromCore(Core::House house) { return static_cast<AuctionHouseId>(house); }
+
+    inline Core::ItemFacts FactsOf(ItemTemplate const &t)
+    {
+        Core::ItemFacts f;
+        f.itemId = t.ItemId;
+        f.quality = uint8(t.Quality);
+        f.itemClass = uint8(t.Class);
+        f.stackable = uint16(std::clamp<int64>(int64(t.Stackable), 1, 0xFFFF));
+        f.sellPrice = t.SellPrice;
+        f.buyPrice = t.BuyPrice;
+        return f;
+    }
+
+    inline Core::AuctionFacts FactsOf(AuctionRow const &r)
+    {
+        return Core::AuctionFacts{r.id, ToCore(r.house), r.itemId, r.count, r.startBid, r.buyout, r.owner, r.hasBidder};
+    }
+
+    // Core interfaces over the live server. DynamicAHPlanner and BuyEngine run the core planners
+    // (Core::SellPlanner, Core::BuyPlanner) through these; tools/ runs them over stubs.
+
+    // Facts column of a DynamicAHItemIndex table. The table is pinned until the next Sync (taken
+    // on first use otherwise), so Find pointers stay valid for a whole cycle even if the world
+    // thread publishes a rebuild meanwhile.
+    class IndexItemCatalog final : public Core::IItemCatalog
+    {
+    public:
+        IndexItemCatalog() = default;
+        explicit IndexItemCatalog(std::shared_ptr<DynamicAHItemIndex::Table const> table) : _table(std::move(table)) {}
+
+        // Adopts the current table (start of a cycle)
+        void Sync() { _table = DynamicAHItemIndex::Get(); }
+        DynamicAHItemIndex::Table const &Items() const
+        {
+            if (!_table)
+                _table = DynamicAHItemIndex::Get();
+            return *_table;
+        }
+        ItemTemplate const *Template(uint32_t itemId) const
+        {
+            DynamicAHItemIndex::Table const &t = Items();
+            uint32 slot = t.Slot(itemId);
+            return slot != DynamicAHItemIndex::NoSlot ? t.tmpl[slot] : nullptr;
+        }
+
+        Core::ItemFacts const *Find(uint32_t itemId) const override
+        {
+            DynamicAHItemIndex::Table const &t = Items();
+            uint32 slot = t.Slot(itemId);
+            return slot != DynamicAHItemIndex::NoSlot ? &t.facts[slot] : nullptr;
+        }
+        void ForEach(std::function<void(Core::ItemFacts const &)> const &fn) const override;
+        uint32_t Generation() const override { return Items().generation; }
+
+    private:
+        mutable std::shared_ptr<DynamicAHItemIndex::Table const> _table;
+    };
+
+    // sAuctionMgr's three houses; world thread
+    class LiveAuctionSource final : public Core::IAuctionSource
+    {
+    public:
+        void Snapshot(std::vector<Core::AuctionFacts> &out) override;
+        size_t ScanHouse(Core::House house, uint32_t afterId, size_t maxRows, std::vector<Core::AuctionFacts> &out) override;
+    };
+
+    class GameClock final : public Core::IClock
+    {
+    public:
+        uint64_t NowMs() const override;
+        uint32_t NowSec() const override;
+    };
+
+    // A game time captured on the world thread, for planning that runs off it
+    class CapturedClock final : public Core::IClock
+    {
+    public:
+        void Set(uint64_t nowMs) { _nowMs = nowMs; }
+
+        uint64_t NowMs() const override { return _nowMs; }
+        uint32_t NowSec() const override { return uint32_t(_nowMs / 1000); }
+
+    private:
+        uint64_t _nowMs = 0;
+    };
+
+} // namespace ModDynamicAH
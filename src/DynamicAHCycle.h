@@ -0,0 +1,43 @@
+#pragma once
+
+#include "CoreBudget.h"
+
+#include <cstdint>
+
+namespace ModDynamicAH
+{
+
+    // Stages of one planning cycle; the service advances them across world ticks.
+    enum class CycleStage : uint8_t
+    {
+        Idle,     // waiting for the next interval
+        Scarcity, // refresh active-auction counts
+        Context,  // profession material plan (sliced per material)
+        Random,   // random sellables plan (sliced per candidate)
+        Handoff,  // move planned posts to the shared post queue
+        BuyPlan,  // scan auction houses for buys (sliced per row)
+    };
+
+    inline char const *CycleStageName(CycleStage s)
+    {
+        switch (s)
+        {
+        case CycleStage::Scarcity:
+            return "scarcity";
+        case CycleStage::Context:
+            return "context";
+        case CycleStage::Random:
+            return "random";
+        case CycleStage::Handoff:
+            return "handoff";
+        case CycleStage::BuyPlan:
+            return "buyplan";
+        default:
+            return "idle";
+        }
+    }
+
+    // Slice budget of the cycle stages (shared with the core planners)
+    using Core::TickBudget;
+
+} // namespace ModDynamicAH
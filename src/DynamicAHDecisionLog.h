@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Chat.h"
+#include "Log.h"
+
+#include <array>
+#include <string>
+#include <string_view>
+
+namespace ModDynamicAH
+{
+
+    // Per-cycle decision accounting for the plan/buy hot loops. Every decision bumps a
+    // per-reason counter; a detail line is only worth formatting when Record() says so
+    // (debug on and the category enabled at DEBUG, or a chat handler asked for an echo),
+    // and at most detailLimit lines per cycle. Use DAH_DECISION so arguments stay unevaluated
+    // otherwise.
+    template <typename Reason, size_t N = size_t(Reason::COUNT)>
+    class DecisionLog
+    {
+    public:
+        DecisionLog(char const *tag, std::array<char const *, N> names) : _tag(tag), _names(names) {}
+
+        void SetDebug(bool on) { _debug = on; }
+        bool Debug() const { return _debug; }
+        void SetDetailLimit(uint32 n) { _detailLimit = n; }
+
+        void BeginCycle()
+        {
+            _counts.fill(0);
+            _emitted = 0;
+            _suppressed = 0;
+        }
+
+        bool Record(Reason r, ChatHandler *handler = nullptr)
+        {
+            ++_counts[size_t(r)];
+            if (!handler && !(_debug && sLog->ShouldLog("mod.dynamicah", LOG_LEVEL_DEBUG)))
+                return false;
+            if (_emitted >= _detailLimit)
+            {
+                ++_suppressed;
+                return false;
+            }
+            ++_emitted;
+            return true;
+        }
+
+        void Emit(ChatHandler *handler, std::string_view what, std::string const &msg) const
+        {
+            if (handler)
+                handler->PSendSysMessage("ModDynamicAH[{}][{}] {}", _tag, what, msg);
+            LOG_DEBUG("mod.dynamicah", "{}[{}] {}", _tag, what, msg);
+        }
+
+        uint32 Count(Reason r) const { return _counts[size_t(r)]; }
+
+        // "reason=count ..." for the non-zero reasons
+        std::string Summary() const
+        {
+            std::string out;
+            for (size_t i = 0; i < N; ++i)
+            {
+                if (!_counts[i])
+                    continue;
+                if (!out.empty())
+                    out += ' ';
+                out += _names[i];
+                out += '=';
+                out += std::to_string(_counts[i]);
+            }
+            if (_suppressed)
+                out += " (detail suppressed " + std::to_string(_suppressed) + ")";
+            return out.empty() ? "none" : out;
+        }
+
+    private:
+        char const *_tag;
+        std::array<char const *, N> _names;
+        std::array<uint32, N> _counts{};
+        uint32 _emitted = 0;
+        uint32 _suppressed = 0;
+        uint32 _detailLimit = 50;
+        bool _debug = false;
+    };
+
+} // namespace ModDynamicAH
+
+// Counts `reason` and, only if a detail line is wanted, formats and emits it.
+#define DAH_DECISION(log, reason, handler, what, ...)                             \
+    do                                                                            \
+    {                                                                             \
+        if ((log).Record((reason), (handler)))                                    \
+            (log).Emit((handler), (what), fmt::format(__VA_ARGS__));              \
+    } while (0)
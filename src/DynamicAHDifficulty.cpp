@@ -2,49 +2,23 @@
 #include "QueryResult.h"
 #include "Field.h"
 #include "DynamicAHDifficulty.h"
+#include "DynamicAHProfessionIndex.h"
 #include "Log.h"
 
+#include <algorithm>
+
 namespace ModDynamicAH
 {
 
-    static std::unordered_map<uint32, uint16> g_skillByItem;
     static std::unordered_map<uint32, uint8> g_minCreatureLvlByItem;
 
-    std::unordered_map<uint32, uint16> &DynamicAHDifficulty::SkillMap() { return g_skillByItem; }
     std::unordered_map<uint32, uint8> &DynamicAHDifficulty::CreatureLvlMap() { return g_minCreatureLvlByItem; }
 
-    static inline void EmplaceMax(std::unordered_map<uint32, uint16> &m, uint32 id, uint16 val)
-    {
-        auto it = m.find(id);
-        if (it == m.end())
-        {
-            m.emplace(id, val);
-            return;
-        }
-        if (val > it->second)
-            it->second = val;
-    }
-
     void DynamicAHDifficulty::Build()
     {
-        g_skillByItem.clear();
         g_minCreatureLvlByItem.clear();
 
-        // A) From DBC: SkillLineAbility -> Spell -> Reagents
-        for (SkillLineAbilityEntry const *abl : sSkillLineAbilityStore)
-        {
-            if (!abl || abl->MinSkillLineRank == 0)
-                continue;
-            SpellInfo const *si = sSpellMgr->GetSpellInfo(abl->Spell);
-            if (!si)
-                continue;
-
-            for (uint32 i = 0; i < MAX_SPELL_REAGENTS; ++i)
-                if (uint32 item = si->Reagent[i])
-                    EmplaceMax(g_skillByItem, item, abl->MinSkillLineRank);
-        }
-
-        // B) DB: min creature level that drops the item
+        // DB: min creature level that drops the item (reagent skill comes from ProfessionIndex)
         if (QueryResult qr = WorldDatabase.Query(R"SQL(
         SELECT l.item, MIN(c.minlevel)
         FROM creature_loot_template l
@@ -62,14 +36,26 @@ namespace ModDynamicAH
             } while (qr->NextRow());
         }
 
-        LOG_INFO("mod.dynamicah", "DynamicAHDifficulty: built skill={} creatureLvls={}",
-                 g_skillByItem.size(), g_minCreatureLvlByItem.size());
+        LOG_INFO("mod.dynamicah", "DynamicAHDifficulty: built creatureLvls={}", g_minCreatureLvlByItem.size());
+    }
+
+    void DynamicAHDifficulty::Export(std::vector<std::pair<uint32, uint8>> &creatureLvl)
+    {
+        creatureLvl.assign(g_minCreatureLvlByItem.begin(), g_minCreatureLvlByItem.end());
+        std::sort(creatureLvl.begin(), creatureLvl.end());
+    }
+
+    void DynamicAHDifficulty::Adopt(std::vector<std::pair<uint32, uint8>> const &creatureLvl)
+    {
+        g_minCreatureLvlByItem.clear();
+        g_minCreatureLvlByItem.reserve(creatureLvl.size());
+        for (auto const &kv : creatureLvl)
+            g_minCreatureLvlByItem.emplace(kv.first, kv.second);
     }
 
     uint16 DynamicAHDifficulty::MaxReqSkillForItem(uint32 itemId)
     {
-        auto it = g_skillByItem.find(itemId);
-        return it != g_skillByItem.end() ? it->second : 0;
+        return ProfessionIndex::Get()->MinRankMax(itemId);
     }
 
     uint8 DynamicAHDifficulty::MinCreatureLevelDropping(uint32 itemId)
@@ -7,6 +7,10 @@
 #include "SpellInfo.h"
 #include "DatabaseEnv.h"
 
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 namespace ModDynamicAH
 {
 
@@ -14,12 +18,15 @@ namespace ModDynamicAH
     class DynamicAHDifficulty
     {
     public:
-        static void Build();                                  // call once on config load
-        static uint16 MaxReqSkillForItem(uint32 itemId);      // from reagents across all professions
+        static void Build();                                  // creature drop levels; call on config load
+        static uint16 MaxReqSkillForItem(uint32 itemId);      // from reagents across all skill lines (ProfessionIndex)
         static uint8 MinCreatureLevelDropping(uint32 itemId); // min creature level that drops the item
 
+        // Persistent cache support (DynamicAHIndexCache); ascending by item id
+        static void Export(std::vector<std::pair<uint32, uint8>> &creatureLvl);
+        static void Adopt(std::vector<std::pair<uint32, uint8>> const &creatureLvl);
+
     private:
-        static std::unordered_map<uint32, uint16> &SkillMap();
         static std::unordered_map<uint32, uint8> &CreatureLvlMap();
     };
 
@@ -0,0 +1,413 @@
+#include "DynamicAHIndexCache.h"
+#include "DynamicAHDifficulty.h"
+#include "DynamicAHProfessionIndex.h"
+#include "DatabaseEnv.h"
+#include "QueryResult.h"
+#include "Field.h"
+#include "DBCStores.h"
+#include "SpellMgr.h"
+#include "SpellInfo.h"
+#include "Log.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ModDynamicAH
+{
+
+    namespace
+    {
+        // Bump whenever the record layout or the meaning of any stored field changes
+        constexpr uint32 kFormatVersion = 4;
+        constexpr char kMagic[8] = {'D', 'A', 'H', 'I', 'D', 'X', '\0', '\0'};
+
+        // All records are fixed-size PODs written in host byte order; the key folds in
+        // sizeof checks below, so a file from another layout simply misses.
+        struct FileHeader
+        {
+            char magic[8];
+            uint32 version;
+            uint32 headerSize;
+            uint64 key;
+            uint32 rowCount;
+            uint32 linkCount;
+            uint32 creatureCount;
+            uint32 buildMs; // how long the build that wrote this file took (key + scan + loot query)
+        };
+
+        // ProfessionIndex row; its links follow in the link section, rows in order
+        struct RowRec
+        {
+            uint32 itemId;
+            uint16 maxSkill;
+            uint16 effSkill;
+            uint16 minRankMax;
+            uint16 pad;
+            uint32 linkCount;
+            uint32 bins[6];
+        };
+
+        struct LinkRec
+        {
+            uint32 spellId;
+            uint16 skillLine;
+            uint16 req;
+        };
+
+        struct LevelRec
+        {
+            uint32 itemId;
+            uint8 level;
+            uint8 pad[3];
+        };
+
+        static_assert(sizeof(FileHeader) == 40, "index cache header layout");
+        static_assert(sizeof(RowRec) == 40, "index cache row record layout");
+        static_assert(sizeof(LinkRec) == 8, "index cache link record layout");
+        static_assert(sizeof(LevelRec) == 8, "index cache level record layout");
+
+        // FNV-1a, 64 bit
+        struct Fnv
+        {
+            uint64 h = 0xcbf29ce484222325ull;
+
+            void Add(void const *data, size_t len)
+            {
+                auto const *p = static_cast<unsigned char const *>(data);
+                for (size_t i = 0; i < len; ++i)
+                {
+                    h ^= p[i];
+                    h *= 0x100000001b3ull;
+                }
+            }
+
+            template <typename T>
+            void Add(T v) { Add(&v, sizeof(v)); }
+        };
+
+        // Read-only view of a whole file: mmap where available, a heap copy otherwise
+        class MappedFile
+        {
+        public:
+            explicit MappedFile(std::string const &path)
+            {
+#ifdef _WIN32
+                std::ifstream in(path, std::ios::binary | std::ios::ate);
+                if (!in)
+                    return;
+                _copy.resize(size_t(in.tellg()));
+                in.seekg(0);
+                if (!in.read(_copy.data(), std::streamsize(_copy.size())))
+                    return;
+                _data = _copy.data();
+                _size = _copy.size();
+#else
+                int fd = ::open(path.c_str(), O_RDONLY);
+                if (fd < 0)
+                    return;
+                struct stat st;
+                if (::fstat(fd, &st) == 0 && st.st_size > 0)
+                {
+                    void *p = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (p != MAP_FAILED)
+                    {
+                        _data = static_cast<char const *>(p);
+                        _size = size_t(st.st_size);
+                    }
+                }
+                ::close(fd);
+#endif
+            }
+
+            ~MappedFile()
+            {
+#ifndef _WIN32
+                if (_data)
+                    ::munmap(const_cast<char *>(_data), _size);
+#endif
+            }
+
+            MappedFile(MappedFile const &) = delete;
+            MappedFile &operator=(MappedFile const &) = delete;
+
+            char const *Data() const { return _data; }
+            size_t Size() const { return _size; }
+
+        private:
+            char const *_data = nullptr;
+            size_t _size = 0;
+#ifdef _WIN32
+            std::vector<char> _copy;
+#endif
+        };
+
+        uint64 g_loadedKey = 0; // key of the indexes currently in memory; 0 = none
+        std::string g_loadedPath;
+        uint32 g_buildMs = 0; // build time of the indexes in memory (recorded in the file when loaded)
+
+        uint32 MsSince(std::chrono::steady_clock::time_point t0)
+        {
+            return uint32(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count());
+        }
+
+        template <typename Rec>
+        Rec const *Records(char const *base, size_t offset)
+        {
+            return reinterpret_cast<Rec const *>(base + offset);
+        }
+
+        // On success, buildMs is the build time recorded by whoever wrote the file
+        bool Load(std::string const &path, uint64 key, uint32 &buildMs)
+        {
+            MappedFile file(path);
+            if (!file.Data() || file.Size() < sizeof(FileHeader))
+                return false;
+
+            FileHeader hdr;
+            std::memcpy(&hdr, file.Data(), sizeof(hdr));
+            if (std::memcmp(hdr.magic, kMagic, sizeof(kMagic)) != 0 || hdr.version != kFormatVersion ||
+                hdr.headerSize != sizeof(FileHeader))
+            {
+                LOG_INFO("mod.dynamicah", "index cache: {} has an unknown format, rebuilding", path);
+                return false;
+            }
+            if (hdr.key != key)
+            {
+                LOG_INFO("mod.dynamicah", "index cache: {} is stale (key {:016x}, inputs {:016x}), rebuilding",
+                         path, hdr.key, key);
+                return false;
+            }
+
+            size_t rowOff = sizeof(FileHeader);
+            size_t linkOff = rowOff + size_t(hdr.rowCount) * sizeof(RowRec);
+            size_t levelOff = linkOff + size_t(hdr.linkCount) * sizeof(LinkRec);
+            size_t end = levelOff + size_t(hdr.creatureCount) * sizeof(LevelRec);
+            if (end != file.Size())
+            {
+                LOG_INFO("mod.dynamicah", "index cache: {} is truncated ({} of {} bytes), rebuilding",
+                         path, file.Size(), end);
+                return false;
+            }
+
+            auto t = std::make_shared<ProfessionIndex::Table>();
+            RowRec const *rr = Records<RowRec>(file.Data(), rowOff);
+            uint32 maxId = hdr.rowCount ? rr[hdr.rowCount - 1].itemId : 0;
+            t->rowOf.assign(hdr.rowCount ? size_t(maxId) + 1 : 0, ProfessionIndex::NoRow);
+            t->itemId.resize(hdr.rowCount);
+            t->maxSkill.resize(hdr.rowCount);
+            t->effSkill.resize(hdr.rowCount);
+            t->minRankMax.resize(hdr.rowCount);
+            t->bins.resize(hdr.rowCount);
+            t->linkBegin.resize(size_t(hdr.rowCount) + 1);
+            t->linkBegin[0] = 0;
+            for (uint32 r = 0; r < hdr.rowCount; ++r)
+            {
+                // rows must be strictly ascending and their link counts must add up
+                if (rr[r].itemId > maxId || (r && rr[r].itemId <= rr[r - 1].itemId) ||
+                    uint64(t->linkBegin[r]) + rr[r].linkCount > hdr.linkCount)
+                {
+                    LOG_INFO("mod.dynamicah", "index cache: {} has inconsistent rows, rebuilding", path);
+                    return false;
+                }
+                t->rowOf[rr[r].itemId] = r;
+                t->itemId[r] = rr[r].itemId;
+                t->maxSkill[r] = rr[r].maxSkill;
+                t->effSkill[r] = rr[r].effSkill;
+                t->minRankMax[r] = rr[r].minRankMax;
+                std::copy(std::begin(rr[r].bins), std::end(rr[r].bins), t->bins[r].begin());
+                t->linkBegin[r + 1] = t->linkBegin[r] + rr[r].linkCount;
+            }
+            if (t->linkBegin[hdr.rowCount] != hdr.linkCount)
+            {
+                LOG_INFO("mod.dynamicah", "index cache: {} has inconsistent rows, rebuilding", path);
+                return false;
+            }
+
+            LinkRec const *lk = Records<LinkRec>(file.Data(), linkOff);
+            t->links.resize(hdr.linkCount);
+            for (uint32 i = 0; i < hdr.linkCount; ++i)
+                t->links[i] = ProfessionIndex::Link{lk[i].spellId, lk[i].skillLine, lk[i].req};
+
+            std::vector<std::pair<uint32, uint8>> levels(hdr.creatureCount);
+            LevelRec const *lr = Records<LevelRec>(file.Data(), levelOff);
+            for (uint32 i = 0; i < hdr.creatureCount; ++i)
+                levels[i] = {lr[i].itemId, lr[i].level};
+
+            ProfessionIndex::Adopt(std::move(t));
+            DynamicAHDifficulty::Adopt(levels);
+            buildMs = hdr.buildMs;
+            return true;
+        }
+
+        bool Save(std::string const &path, uint64 key, uint32 buildMs)
+        {
+            auto t = ProfessionIndex::Get();
+            std::vector<std::pair<uint32, uint8>> levels;
+            DynamicAHDifficulty::Export(levels);
+
+            std::vector<char> buf(sizeof(FileHeader) + t->Size() * sizeof(RowRec) +
+                                  t->links.size() * sizeof(LinkRec) + levels.size() * sizeof(LevelRec));
+            char *out = buf.data();
+
+            FileHeader hdr{};
+            std::memcpy(hdr.magic, kMagic, sizeof(kMagic));
+            hdr.version = kFormatVersion;
+            hdr.headerSize = sizeof(FileHeader);
+            hdr.key = key;
+            hdr.rowCount = uint32(t->Size());
+            hdr.linkCount = uint32(t->links.size());
+            hdr.creatureCount = uint32(levels.size());
+            hdr.buildMs = buildMs;
+            std::memcpy(out, &hdr, sizeof(hdr));
+            out += sizeof(hdr);
+
+            for (size_t r = 0; r < t->Size(); ++r)
+            {
+                RowRec rec{};
+                rec.itemId = t->itemId[r];
+                rec.maxSkill = t->maxSkill[r];
+                rec.effSkill = t->effSkill[r];
+                rec.minRankMax = t->minRankMax[r];
+                rec.linkCount = t->linkBegin[r + 1] - t->linkBegin[r];
+                std::copy(t->bins[r].begin(), t->bins[r].end(), rec.bins);
+                std::memcpy(out, &rec, sizeof(rec));
+                out += sizeof(rec);
+            }
+            for (ProfessionIndex::Link const &l : t->links)
+            {
+                LinkRec rec{l.spellId, l.skillLine, l.req};
+                std::memcpy(out, &rec, sizeof(rec));
+                out += sizeof(rec);
+            }
+            for (auto const &kv : levels)
+            {
+                LevelRec rec{};
+                rec.itemId = kv.first;
+                rec.level = kv.second;
+                std::memcpy(out, &rec, sizeof(rec));
+                out += sizeof(rec);
+            }
+
+            // Write beside the target and rename, so a crash never leaves a half-written cache
+            std::string tmp = path + ".tmp";
+            FILE *f = std::fopen(tmp.c_str(), "wb");
+            if (!f)
+                return false;
+            bool ok = std::fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+            ok = (std::fclose(f) == 0) && ok;
+            if (ok)
+                ok = std::rename(tmp.c_str(), path.c_str()) == 0;
+            if (!ok)
+                std::remove(tmp.c_str());
+            return ok;
+        }
+    } // namespace
+
+    uint64 DynamicAHIndexCache::InputKey()
+    {
+        Fnv fnv;
+        fnv.Add(kFormatVersion);
+        fnv.Add(uint32(sizeof(FileHeader) + sizeof(RowRec) + sizeof(LinkRec) + sizeof(LevelRec)));
+
+        // DBC: every ability row the profession index reads, the skill line it belongs to and the
+        // reagents of its spell.
+        fnv.Add(sSpellStore.GetNumRows());
+        fnv.Add(sSkillLineStore.GetNumRows());
+        for (SkillLineAbilityEntry const *abl : sSkillLineAbilityStore)
+        {
+            if (!abl)
+                continue;
+            fnv.Add(abl->ID);
+            fnv.Add(abl->SkillLine);
+            fnv.Add(abl->Spell);
+            fnv.Add(abl->MinSkillLineRank);
+            fnv.Add(abl->TrivialSkillLineRankHigh);
+            fnv.Add(abl->TrivialSkillLineRankLow);
+            if (SkillLineEntry const *line = sSkillLineStore.LookupEntry(abl->SkillLine))
+                fnv.Add(line->categoryId);
+            if (SpellInfo const *si = sSpellMgr->GetSpellInfo(abl->Spell))
+                for (uint32 i = 0; i < MAX_SPELL_REAGENTS; ++i)
+                    fnv.Add(si->Reagent[i]);
+        }
+
+        // World DB: order-independent aggregates over the loot rows and creature levels the
+        // difficulty query joins. A fingerprint, not a content hash; good enough to notice edits.
+        if (QueryResult qr = WorldDatabase.Query(R"SQL(
+        SELECT
+            (SELECT COUNT(*) FROM creature_loot_template),
+            (SELECT CAST(COALESCE(SUM(CRC32(CONCAT_WS(':', entry, item))), 0) AS UNSIGNED) FROM creature_loot_template),
+            (SELECT COUNT(*) FROM creature_template),
+            (SELECT CAST(COALESCE(SUM(CRC32(CONCAT_WS(':', entry, minlevel))), 0) AS UNSIGNED) FROM creature_template)
+    )SQL"))
+        {
+            Field *f = qr->Fetch();
+            for (int i = 0; i < 4; ++i)
+                fnv.Add(f[i].Get<uint64>());
+        }
+
+        // 0 means "nothing loaded"
+        return fnv.h ? fnv.h : 1;
+    }
+
+    void DynamicAHIndexCache::LoadOrBuild(std::string const &path)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        uint64 key = InputKey();
+        uint32 keyMs = MsSince(t0);
+
+        if (key == g_loadedKey)
+        {
+            // unchanged inputs; only the file setting moved, so write the indexes we hold there
+            if (!path.empty() && path != g_loadedPath && !Save(path, key, g_buildMs))
+                LOG_INFO("mod.dynamicah", "index cache: could not write {}", path);
+            g_loadedPath = path;
+            return;
+        }
+
+        uint32 fileBuildMs = 0;
+        if (!path.empty() && Load(path, key, fileBuildMs))
+        {
+            g_loadedKey = key;
+            g_loadedPath = path;
+            g_buildMs = fileBuildMs;
+            LOG_INFO("mod.dynamicah", "index cache: loaded {} in {} ms (key {} ms); building it took {} ms",
+                     path, MsSince(t0), keyMs, fileBuildMs);
+            return;
+        }
+
+        // the sharded ability scan runs in the background while the loot aggregate runs here
+        if (g_loadedKey)
+            ProfessionIndex::Rebuild();
+        else
+            ProfessionIndex::StartBuild();
+        DynamicAHDifficulty::Build();
+        g_loadedKey = key;
+        g_loadedPath = path;
+
+        if (path.empty())
+        {
+            // nothing to write, so startup does not wait for the scan
+            LOG_INFO("mod.dynamicah", "index cache: disabled, drop levels in {} ms, profession index building in the background (key {} ms)",
+                     MsSince(t0), keyMs);
+            return;
+        }
+
+        ProfessionIndex::Get(); // wait, so the time covers the whole build
+        g_buildMs = MsSince(t0);
+        LOG_INFO("mod.dynamicah", "index cache: built in {} ms (key {} ms, {:016x})", g_buildMs, keyMs, key);
+        if (!Save(path, key, g_buildMs))
+            LOG_INFO("mod.dynamicah", "index cache: could not write {}", path);
+    }
+
+} // namespace ModDynamicAH
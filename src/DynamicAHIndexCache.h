@@ -0,0 +1,28 @@
+#pragma once
+
+#include "DynamicAHTypes.h"
+
+#include <string>
+
+namespace ModDynamicAH
+{
+
+    // Versioned on-disk snapshot of the startup indexes that are pure functions of DBC and world
+    // DB content: ProfessionIndex (reagent -> recipe skill, bins and links) and DynamicAHDifficulty
+    // (min creature drop level). The file carries a key fingerprinting those inputs; when it
+    // matches, the indexes are mapped in instead of rescanning the ability store and re-running
+    // the loot aggregate.
+    class DynamicAHIndexCache
+    {
+    public:
+        // Load the indexes from `path` when its key matches the current inputs, otherwise build
+        // them and rewrite the file. Empty path: always build, never write. Logs the time taken
+        // next to the build time stored in the file, so a cached start can be compared with a
+        // cold one. World thread.
+        static void LoadOrBuild(std::string const &path);
+
+        // Fingerprint of the DBC and world DB inputs (format version folded in)
+        static uint64 InputKey();
+    };
+
+} // namespace ModDynamicAH
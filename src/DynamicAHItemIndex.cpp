@@ -0,0 +1,88 @@
+#include "DynamicAHItemIndex.h"
+#include "DynamicAHProfessionIndex.h"
+#include "DynamicAHCoreAdapters.h"
+#include "CoreMaterials.h"
+#include "ObjectMgr.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+namespace ModDynamicAH
+{
+
+    static std::shared_ptr<DynamicAHItemIndex::Table const> g_itemIndex;
+    static std::mutex g_itemIndexBuildLock;
+    static uint32 g_itemIndexBuilds = 0; // under the build lock
+
+    static std::shared_ptr<DynamicAHItemIndex::Table const> BuildTable()
+    {
+        auto t = std::make_shared<DynamicAHItemIndex::Table>();
+        t->generation = ++g_itemIndexBuilds;
+
+        std::vector<ItemTemplate const *> tmpls;
+        if (auto const *store = sObjectMgr->GetItemTemplateStore())
+        {
+            tmpls.reserve(store->size());
+            for (auto const &kv : *store)
+                tmpls.push_back(&kv.second);
+        }
+        std::sort(tmpls.begin(), tmpls.end(), [](ItemTemplate const *a, ItemTemplate const *b)
+                  { return a->ItemId < b->ItemId; });
+
+        size_t n = tmpls.size();
+        t->slotOf.assign(n ? size_t(tmpls.back()->ItemId) + 1 : 0, DynamicAHItemIndex::NoSlot);
+        t->itemId.resize(n);
+        t->tmpl.resize(n);
+        t->facts.resize(n);
+
+        auto prof = ProfessionIndex::Get();
+
+        for (uint32 slot = 0; slot < n; ++slot)
+        {
+            ItemTemplate const *it = tmpls[slot];
+            uint32 id = it->ItemId;
+            t->slotOf[id] = slot;
+            t->itemId[slot] = id;
+            t->tmpl[slot] = it;
+            Core::ItemFacts &f = t->facts[slot];
+            f = FactsOf(*it);
+            f.recipeEff = prof->EffectiveSkill(id);
+            f.recipeMax = prof->MaxSkill(id);
+        }
+
+        for (Core::MatInfo const &m : Core::MAT_INDEX)
+        {
+            uint32 slot = t->Slot(m.itemId);
+            if (slot == DynamicAHItemIndex::NoSlot)
+                continue;
+            t->facts[slot].category = m.category;
+        }
+
+        return t;
+    }
+
+    void DynamicAHItemIndex::Build()
+    {
+        std::lock_guard<std::mutex> lock(g_itemIndexBuildLock);
+        auto t = BuildTable();
+        LOG_INFO("mod.dynamicah", "items: indexed {} templates (max item id {})", t->Size(),
+                 t->slotOf.empty() ? 0 : t->slotOf.size() - 1);
+        std::atomic_store(&g_itemIndex, t);
+    }
+
+    std::shared_ptr<DynamicAHItemIndex::Table const> DynamicAHItemIndex::Get()
+    {
+        if (auto t = std::atomic_load(&g_itemIndex))
+            return t;
+
+        std::lock_guard<std::mutex> lock(g_itemIndexBuildLock);
+        if (auto t = std::atomic_load(&g_itemIndex))
+            return t;
+        auto t = BuildTable();
+        std::atomic_store(&g_itemIndex, t);
+        return t;
+    }
+
+} // namespace ModDynamicAH
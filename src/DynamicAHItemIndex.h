@@ -0,0 +1,42 @@
+#pragma once
+
+#include "DynamicAHTypes.h"
+
+#include <memory>
+#include <vector>
+
+namespace ModDynamicAH
+{
+
+    // Per-item facts the planner and buy engine read on every priced item, gathered once into a
+    // struct-of-arrays table (IndexItemCatalog serves the facts column to the core planners). Item
+    // ids map to dense slots through a flat id -> slot array, so a lookup is two array reads
+    // instead of a template, recipe and category hash probe each.
+    class DynamicAHItemIndex
+    {
+    public:
+        static constexpr uint32 NoSlot = UINT32_MAX;
+
+        struct Table
+        {
+            uint32 generation = 0;      // 1 + number of earlier builds; slots are only valid per generation
+            std::vector<uint32> slotOf; // item id -> slot
+
+            // columns, one entry per slot (slots in ascending item id)
+            std::vector<uint32> itemId;
+            std::vector<ItemTemplate const *> tmpl;
+            std::vector<Core::ItemFacts> facts; // template + recipe skills + material category
+
+            uint32 Slot(uint32 id) const { return id < slotOf.size() ? slotOf[id] : NoSlot; }
+            size_t Size() const { return itemId.size(); }
+        };
+
+        // Walks the template store and joins in ProfessionMats and the profession index. World
+        // thread; run again when the profession index is rebuilt.
+        static void Build();
+
+        // Current table, built on first use. Never null; readers keep the snapshot for a cycle.
+        static std::shared_ptr<Table const> Get();
+    };
+
+} // namespace ModDynamicAH
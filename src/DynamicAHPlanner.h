@@ -2,98 +2,116 @@
 
 #include "DynamicAHTypes.h"
 #include "DynamicAHScarcity.h"
-#include "DynamicAHVendor.h"
-#include "DynamicAHPricing.h"
-#include "ProfessionMats.h" // your existing mat tables
-#include "DynamicAHSelection.h"
-
-class Player;
+#include "DynamicAHCycle.h"
+#include "DynamicAHDecisionLog.h"
+#include "DynamicAHCoreAdapters.h"
+#include "CoreSellPlanner.h"
 
 namespace ModDynamicAH
 {
     struct ModuleState;
 
     // Runtime, per-cycle caches & config are owned by world; planner only builds queues.
-    struct PlannerConfig
+    // Prices, stacks, the context/random switches and the pool filter are Core::SellRules.
+    struct PlannerConfig : Core::SellRules
     {
-        // general
-        bool enableSeller = true;
-        uint32 minPriceCopper = 10000;
-
-        // categories multipliers
-        double mulDust = 1.00;
-        double mulEssence = 1.25;
-        double mulShard = 2.00;
-        double mulElemental = 3.00;
-        double mulRareRaw = 3.00;
-
         // scarcity
-        bool scarcityEnabled = true;
-        double scarcityPriceBoostMax = 0.30;
         uint32 scarcityPerItemPerTickCap = 1;
+        bool scarcityFromMemory = true; // count live AuctionHouseObject maps instead of SQL
+        bool scarcityCountUnits = false; // also tally stacked units (itemCount)
+        uint32 scarcityVerifyEvery = 12; // cycles between full recounts of the incremental index (0 = never)
 
         // vendor
-        double vendorMinMarkup = 0.25;
         bool vendorConsiderBuyPrice = true;
 
-        // stacks
-        uint32 stDefault = 20, stCloth = 20, stOre = 20, stBar = 20, stHerb = 20, stLeather = 20, stDust = 20, stGem = 20, stStone = 20, stMeat = 20, stBandage = 20, stPotion = 5, stInk = 10, stPigment = 20, stFish = 20;
-        uint32 stacksLow = 2, stacksMid = 3, stacksHigh = 2;
-
         // context planner
-        bool contextEnabled = true;
         uint32 contextMaxPerBracket = 4;
         double contextWeightBoost = 1.5;
         bool contextSkipVendor = true;
 
-        // random selection
-        bool blockTrashAndCommon = true;
-        bool allowQuality[6] = {false, false, true, true, true, false};
-        std::unordered_set<uint32> whitelist;
-        uint32 maxRandomPerCycle = 50;
+        // logging: per-item plan lines (rate limited) instead of the per-cycle summary only
+        bool debugLogs = false;
+        uint32 logDetailPerCycle = 50;
 
         // economy
         double avgGoldPerQuest = 10.0;
         uint32 questsPerFamily[(size_t)Family::COUNT] = {0};
     };
 
-    class DynamicAHPlanner
+    using Core::PlanReason;
+    using Core::PlanReasonNames;
+    using Core::PriceKey;
+    using Core::PriceCacheStats;
+
+    // Worldserver host of Core::SellPlanner: items come from the item index, active counts from
+    // the scarcity index and time from the clock it is given; planned posts land in Queue(), prices
+    // in the flight recorder and decisions in the PLAN log.
+    class DynamicAHPlanner final : private Core::IPersistenceSink, private Core::ISellObserver
     {
     public:
+        explicit DynamicAHPlanner(Core::IClock const &clock) : _core(_catalog, _scarcity, clock, *this)
+        {
+            _core.SetObserver(this);
+        }
+        DynamicAHPlanner(DynamicAHPlanner const &) = delete;
+        DynamicAHPlanner &operator=(DynamicAHPlanner const &) = delete;
+
         void ResetTick(uint32 onlineCount);
-        void BuildScarcityCache(ModuleState const &s);
+        void BuildScarcityCache(uint32 onlineCount);
+        // world-thread variant: keeps planning on the last counts while the DB aggregates
+        void RequestScarcityRebuild(QueryCallbackProcessor &proc, uint32 onlineCount);
+        // in-memory source: seeds the hook-fed index on first use, afterwards only recounts every
+        // scarcityVerifyEvery cycles. World thread only.
+        void SyncScarcityIndex(PlannerConfig const &cfg, uint32 onlineCount);
+        // worker variant: plans against a copy of the world thread's index
+        void AdoptScarcity(DynamicAHScarcity::CountMap &&counts, uint32 onlineCount);
+        DynamicAHScarcity &Scarcity() { return _scarcity; }
+        DynamicAHScarcity const &Scarcity() const { return _scarcity; }
 
         void BuildContextPlan(PlannerConfig const &cfg);
         void BuildRandomPlan(PlannerConfig const &cfg);
+
+        // resumable variants: Begin* prepares the work list, Step* returns true once it is exhausted
+        void BeginContextPlan(PlannerConfig const &cfg);
+        bool StepContextPlan(PlannerConfig const &cfg, TickBudget const &budget);
+        void BeginRandomPlan(PlannerConfig const &cfg);
+        bool StepRandomPlan(PlannerConfig const &cfg, TickBudget const &budget);
         // pricing helpers
-        void PriceWithPolicies(PlannerConfig const &cfg, Family fam, uint32 itemId, ItemTemplate const *tmpl,
-                               AuctionHouseId house, uint32 &outStart, uint32 &outBuy) const;
-        static uint32 ClampToStackable(ItemTemplate const *tmpl, uint32 desired);
+        void PriceWithPolicies(PlannerConfig const &cfg, Family fam, Core::ItemFacts const &item,
+                               AuctionHouseId house, uint32 &outStart, uint32 &outBuy) const
+        {
+            _core.PriceWithPolicies(cfg, fam, item, ToCore(house), outStart, outBuy);
+        }
+        void PrimePrices(PlannerConfig const &cfg, std::vector<PriceKey> const &keys) { _core.PrimePrices(cfg, keys); }
+        // Builds the sellable pool for the filter against the current item index (reload warm-up);
+        // returns its size
+        size_t WarmPool(Core::SelectionRules const &rules);
+
+        // item facts from the cycle's DynamicAHItemIndex snapshot (taken by Begin*/ResetTick)
+        IndexItemCatalog const &Catalog() const { return _catalog; }
+        PriceCacheStats PriceStats() const { return _core.PriceStats(); }
         PostQueue &Queue() { return _queue; }
 
+        uint32 ScarcityCount(uint32 itemId, AuctionHouseId house) const { return _scarcity.Count(itemId, house); }
+        uint32 ScarcityUnits(uint32 itemId, AuctionHouseId house) const { return _scarcity.Units(itemId, house); }
+
     private:
-        static double Jitter(uint32 itemId);
-        static uint32 StacksForSkill(uint16 s, PlannerConfig const &cfg);
+        // Core::IPersistenceSink: posts go to the queue (the sell planner never buys)
+        void Post(Core::PostDecision const &d) override;
+        void Buy(Core::BuyDecision const & /*d*/) override {}
 
-        // post cap per-item per tick
-    public:
-        uint32 ScarcityCount(uint32 itemId, AuctionHouseId house) const;
-        bool TryPlanOnce(AuctionHouseId house, uint32 itemId);
+        // Core::ISellObserver: flight recorder + PLAN decision log
+        void Priced(Family fam, Core::House house, uint32 itemId, uint32 active, Core::PricingResult const &unit) override;
+        void Planned(PlanReason reason, Core::ItemFacts const &item, Core::PostDecision const &post,
+                     Core::PricingResult const &unit, uint32 stacks) override;
+        void Skipped(PlanReason reason, uint32 /*itemId*/) override { _log.Record(reason); }
 
-    public:
         PostQueue _queue;
-        std::unordered_map<uint64, uint32> _perTickPlanCap; // (house<<32)|itemId -> count this tick
         DynamicAHScarcity _scarcity;
-        uint32 _online = 0;
-
-        // category sets (built once)
-        static std::unordered_set<uint32> &EssenceSet();
-        static std::unordered_set<uint32> &ShardSet();
-        static std::unordered_set<uint32> &ElementalSet();
-        static std::unordered_set<uint32> &RareRawSet();
-
-        static double CategoryMul(PlannerConfig const &cfg, uint32 itemId);
-        static void InitCategorySetsOnce();
+        IndexItemCatalog _catalog;
+        DecisionLog<PlanReason> _log{"PLAN", PlanReasonNames};
+        uint32 _scarcitySinceVerify = 0;
+        Core::SellPlanner _core; // after the members it references
     };
 
 } // namespace ModDynamicAH
@@ -9,6 +9,7 @@
 #include "Log.h"
 #include "Item.h"
 #include "DatabaseEnv.h"
+#include "DynamicAHTrace.h"
 
 namespace ModDynamicAH
 {
@@ -111,30 +112,53 @@ namespace ModDynamicAH
     // Batch apply: one begin/commit for the whole batch
     void DynamicAHPosting::ApplyPlanOnWorld(ModuleState &s, uint32 maxToApply, ChatHandler *handler)
     {
-        auto batch = s.postQueue.Drain(maxToApply);
-        if (batch.empty())
+        if (maxToApply == 0 || s.postQueue.Size() == 0)
             return;
 
+        // drained in fixed chunks so the hot path never allocates
+        PostRequest batch[64];
+
         if (s.dryRun)
         {
+            uint32 skipped = 0;
+            while (skipped < maxToApply)
+            {
+                uint32 n = s.postQueue.DrainInto(batch, std::min<uint32>(64, maxToApply - skipped));
+                if (!n)
+                    break;
+                skipped += n;
+                for (uint32 i = 0; i < n; ++i)
+                    FlightRecorder::Record(TraceStage::Post, uint8(TracePostResult::DryRun), batch[i].house,
+                                           batch[i].itemId, batch[i].count, batch[i].startBid, batch[i].buyout);
+            }
             if (handler)
-                handler->PSendSysMessage("ModDynamicAH (dry-run): would post {} auctions.", uint32(batch.size()));
+                handler->PSendSysMessage("ModDynamicAH (dry-run): would post {} auctions.", skipped);
             return;
         }
 
         CharacterDatabaseTransaction trans = CharacterDatabase.BeginTransaction();
 
-        uint32 posted = 0;
-        for (auto const &r : batch)
+        uint32 taken = 0, posted = 0;
+        while (taken < maxToApply)
         {
-            if (PostSingleAuction(s, r.house, r.itemId, r.count, r.startBid, r.buyout, r.duration, handler, trans))
-                ++posted;
+            uint32 n = s.postQueue.DrainInto(batch, std::min<uint32>(64, maxToApply - taken));
+            if (!n)
+                break;
+            taken += n;
+            for (uint32 i = 0; i < n; ++i)
+            {
+                PostRequest const &r = batch[i];
+                bool ok = PostSingleAuction(s, r.house, r.itemId, r.count, r.startBid, r.buyout, r.duration, handler, trans);
+                posted += ok ? 1 : 0;
+                FlightRecorder::Record(TraceStage::Post, uint8(ok ? TracePostResult::Posted : TracePostResult::Failed),
+                                       r.house, r.itemId, r.count, r.startBid, r.buyout);
+            }
         }
 
         CharacterDatabase.CommitTransaction(trans);
 
         if (handler)
             handler->PSendSysMessage("ModDynamicAH: posted {}/{} auctions in a single DB commit.",
-                                     posted, uint32(batch.size()));
+                                     posted, taken);
     }
 } // namespace ModDynamicAH
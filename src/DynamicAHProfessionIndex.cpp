@@ -0,0 +1,251 @@
+#include "DynamicAHProfessionIndex.h"
+#include "DBCStores.h"
+#include "SpellMgr.h"
+#include "SpellInfo.h"
+#include "SharedDefines.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <tuple>
+
+namespace ModDynamicAH
+{
+
+    namespace
+    {
+        std::shared_ptr<ProfessionIndex::Table const> g_table;
+        std::mutex g_buildLock;
+        std::future<void> g_pending;             // background build, under g_buildLock
+        std::atomic<bool> g_building{false};     // g_pending is valid; Get must not trust g_table
+        std::atomic<uint32> g_threads{0};
+
+        // One (ability, reagent slot) pair; the sort + linear pass below turns these into rows
+        struct Use
+        {
+            uint32 itemId;
+            uint32 spellId;
+            uint16 skillLine;
+            uint16 req;
+            uint16 minRank;
+            bool profession; // skill line is a primary or secondary profession
+
+            bool operator<(Use const &o) const
+            {
+                return std::tie(itemId, spellId, skillLine, req, minRank, profession) <
+                       std::tie(o.itemId, o.spellId, o.skillLine, o.req, o.minRank, o.profession);
+            }
+        };
+
+        struct BuildShard
+        {
+            std::vector<Use> uses;
+            uint32 abilities = 0;
+            uint32 withSpell = 0;
+        };
+
+        void ScanAbilities(BuildShard &sh, uint32 first, uint32 last)
+        {
+            for (uint32 i = first; i < last; ++i)
+            {
+                SkillLineAbilityEntry const *abl = sSkillLineAbilityStore.LookupEntry(i);
+                if (!abl)
+                    continue;
+                ++sh.abilities;
+
+                SpellInfo const *si = sSpellMgr->GetSpellInfo(abl->Spell);
+                if (!si)
+                    continue;
+                ++sh.withSpell;
+
+                SkillLineEntry const *line = sSkillLineStore.LookupEntry(abl->SkillLine);
+                bool prof = line && (line->categoryId == SKILL_CATEGORY_PROFESSION ||
+                                     line->categoryId == SKILL_CATEGORY_SECONDARY);
+                if (!prof && abl->MinSkillLineRank == 0)
+                    continue; // contributes to neither column
+
+                Use u;
+                u.spellId = abl->Spell;
+                u.skillLine = uint16(abl->SkillLine);
+                u.req = uint16(std::max(abl->MinSkillLineRank, abl->TrivialSkillLineRankHigh));
+                u.minRank = uint16(abl->MinSkillLineRank);
+                u.profession = prof;
+                for (uint32 r = 0; r < MAX_SPELL_REAGENTS; ++r)
+                {
+                    if (si->Reagent[r] <= 0)
+                        continue;
+                    u.itemId = uint32(si->Reagent[r]);
+                    sh.uses.push_back(u);
+                }
+            }
+        }
+
+        uint16 EffectiveSkill(std::array<uint32, 6> const &bins, uint32 count, uint16 maxSkill)
+        {
+            if (!count)
+                return 0;
+
+            // Approx median from bins
+            uint32 half = count / 2 + (count % 2);
+            uint32 cum = 0;
+            int medBin = 0;
+            for (; medBin < 5; ++medBin)
+            {
+                cum += bins[medBin];
+                if (cum >= half)
+                    break;
+            }
+            static uint16 const binMid[6] = {37, 112, 187, 262, 337, 413};
+
+            // Blend median toward max when many recipes are high tier (>= 300)
+            double highShare = double(bins[4] + bins[5]) / double(count);
+            double alpha = std::clamp(0.2 + 0.4 * highShare, 0.2, 0.6);
+            double eff = (1.0 - alpha) * double(binMid[medBin]) + alpha * double(maxSkill);
+            return uint16(std::clamp(eff, 0.0, 65535.0) + 0.5);
+        }
+
+        int BinOf(uint16 req)
+        {
+            return (req < 75) ? 0 : (req < 150) ? 1
+                                : (req < 225)   ? 2
+                                : (req < 300)   ? 3
+                                : (req < 375)   ? 4
+                                                : 5;
+        }
+
+        std::shared_ptr<ProfessionIndex::Table const> BuildTable()
+        {
+            auto t0 = std::chrono::steady_clock::now();
+            uint32 rows = sSkillLineAbilityStore.GetNumRows();
+
+            // Shards below ~2k rows cost more in thread start-up than they save
+            uint32 threads = g_threads.load(std::memory_order_relaxed);
+            if (!threads)
+                threads = std::min<uint32>(std::max(1u, std::thread::hardware_concurrency()), 8u);
+            threads = std::max<uint32>(1, std::min<uint32>(threads, rows / 2048 + 1));
+
+            std::vector<BuildShard> shards(threads);
+            std::vector<std::thread> pool;
+            pool.reserve(threads - 1);
+            for (uint32 s = 1; s < threads; ++s)
+                pool.emplace_back(ScanAbilities, std::ref(shards[s]),
+                                  uint32(uint64(rows) * s / threads), uint32(uint64(rows) * (s + 1) / threads));
+            ScanAbilities(shards[0], 0, uint32(uint64(rows) / threads));
+            for (std::thread &th : pool)
+                th.join();
+
+            // merge = concatenate + sort; the result does not depend on the shard count
+            std::vector<Use> &uses = shards[0].uses;
+            for (uint32 s = 1; s < threads; ++s)
+            {
+                uses.insert(uses.end(), shards[s].uses.begin(), shards[s].uses.end());
+                shards[0].abilities += shards[s].abilities;
+                shards[0].withSpell += shards[s].withSpell;
+            }
+            std::sort(uses.begin(), uses.end());
+
+            auto t = std::make_shared<ProfessionIndex::Table>();
+            t->rowOf.assign(uses.empty() ? 0 : size_t(uses.back().itemId) + 1, ProfessionIndex::NoRow);
+            t->linkBegin.push_back(0);
+            for (size_t i = 0; i < uses.size();)
+            {
+                uint32 id = uses[i].itemId;
+                uint16 maxSkill = 0;
+                uint16 minRankMax = 0;
+                std::array<uint32, 6> bins{};
+                for (; i < uses.size() && uses[i].itemId == id; ++i)
+                {
+                    Use const &u = uses[i];
+                    minRankMax = std::max(minRankMax, u.minRank);
+                    if (!u.profession)
+                        continue;
+                    maxSkill = std::max(maxSkill, u.req);
+                    ++bins[BinOf(u.req)];
+                    t->links.push_back(ProfessionIndex::Link{u.spellId, u.skillLine, u.req});
+                }
+
+                uint32 count = uint32(t->links.size()) - t->linkBegin.back();
+                t->rowOf[id] = uint32(t->itemId.size());
+                t->itemId.push_back(id);
+                t->maxSkill.push_back(maxSkill);
+                t->effSkill.push_back(EffectiveSkill(bins, count, maxSkill));
+                t->minRankMax.push_back(minRankMax);
+                t->bins.push_back(bins);
+                t->linkBegin.push_back(uint32(t->links.size()));
+            }
+
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count();
+            LOG_INFO("mod.dynamicah", "professions: indexed abilities={} withSpell={} reagents={} recipeLinks={} threads={} ms={}",
+                     shards[0].abilities, shards[0].withSpell, t->Size(), t->links.size(), threads, ms);
+            return t;
+        }
+
+        void Publish(std::shared_ptr<ProfessionIndex::Table const> t)
+        {
+            std::atomic_store(&g_table, std::move(t));
+        }
+
+        // under g_buildLock
+        void WaitPending()
+        {
+            if (g_pending.valid())
+                g_pending.get();
+            g_building.store(false, std::memory_order_release);
+        }
+
+        // under g_buildLock
+        void Launch()
+        {
+            g_building.store(true, std::memory_order_release);
+            g_pending = std::async(std::launch::async, []
+                                   { Publish(BuildTable()); });
+        }
+    } // namespace
+
+    void ProfessionIndex::SetBuildThreads(uint32 threads)
+    {
+        g_threads.store(threads, std::memory_order_relaxed);
+    }
+
+    void ProfessionIndex::StartBuild()
+    {
+        std::lock_guard<std::mutex> lock(g_buildLock);
+        if (g_building.load(std::memory_order_acquire) || std::atomic_load(&g_table))
+            return;
+        Launch();
+    }
+
+    void ProfessionIndex::Rebuild()
+    {
+        std::lock_guard<std::mutex> lock(g_buildLock);
+        WaitPending();
+        Launch();
+    }
+
+    void ProfessionIndex::Adopt(std::shared_ptr<Table const> table)
+    {
+        std::lock_guard<std::mutex> lock(g_buildLock);
+        WaitPending();
+        Publish(std::move(table));
+    }
+
+    std::shared_ptr<ProfessionIndex::Table const> ProfessionIndex::Get()
+    {
+        if (!g_building.load(std::memory_order_acquire))
+            if (auto t = std::atomic_load(&g_table))
+                return t;
+
+        std::lock_guard<std::mutex> lock(g_buildLock);
+        WaitPending();
+        if (auto t = std::atomic_load(&g_table))
+            return t;
+        auto t = BuildTable();
+        Publish(t);
+        return t;
+    }
+
+} // namespace ModDynamicAH
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "DynamicAHTypes.h"
+
+#include <array>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace ModDynamicAH
+{
+
+    // Reagent -> recipe facts for every item used by a trade skill, built in one pass over the
+    // SkillLineAbility store (each ability row -> its spell's reagents). Replaces the separate
+    // spell-store scan that fed the recipe skill distribution and the ability walk that fed
+    // DynamicAHDifficulty's reagent skill. Rows are dense (ascending item id) and reached through
+    // a flat item id -> row array, like DynamicAHItemIndex.
+    class ProfessionIndex
+    {
+    public:
+        static constexpr uint32 NoRow = UINT32_MAX;
+
+        // One profession/secondary-skill recipe using the reagent
+        struct Link
+        {
+            uint32 spellId = 0;
+            uint16 skillLine = 0;
+            uint16 req = 0; // max(MinSkillLineRank, TrivialSkillLineRankHigh)
+        };
+
+        struct Table
+        {
+            std::vector<uint32> rowOf; // item id -> row
+
+            // columns, one entry per reagent row
+            std::vector<uint32> itemId;
+            std::vector<uint16> maxSkill;   // highest req among profession recipes (0 = none)
+            std::vector<uint16> effSkill;   // median of req blended toward maxSkill when usage skews late-game
+            std::vector<uint16> minRankMax; // highest MinSkillLineRank over abilities of any skill line
+            std::vector<std::array<uint32, 6>> bins; // req in [0-75), [75-150), ... [375-450+]
+            std::vector<uint32> linkBegin;  // rows + 1 entries; row r owns links [linkBegin[r], linkBegin[r+1])
+            std::vector<Link> links;        // ascending (spellId, skillLine) within a row
+
+            uint32 Row(uint32 id) const { return id < rowOf.size() ? rowOf[id] : NoRow; }
+            size_t Size() const { return itemId.size(); }
+
+            uint16 MaxSkill(uint32 id) const { return Column(maxSkill, id); }
+            uint16 EffectiveSkill(uint32 id) const { return Column(effSkill, id); }
+            uint16 MinRankMax(uint32 id) const { return Column(minRankMax, id); }
+
+            uint32 RecipeCount(uint32 id) const
+            {
+                uint32 r = Row(id);
+                return r == NoRow ? 0 : linkBegin[r + 1] - linkBegin[r];
+            }
+
+            std::pair<Link const *, Link const *> Links(uint32 id) const
+            {
+                uint32 r = Row(id);
+                if (r == NoRow)
+                    return {nullptr, nullptr};
+                return {links.data() + linkBegin[r], links.data() + linkBegin[r + 1]};
+            }
+
+        private:
+            uint16 Column(std::vector<uint16> const &col, uint32 id) const
+            {
+                uint32 r = Row(id);
+                return r == NoRow ? 0 : col[r];
+            }
+        };
+
+        // Scan threads for the next build (0 = one per hardware thread, capped at 8)
+        static void SetBuildThreads(uint32 threads);
+
+        // Begin building in the background; no-op when a table is published or a build is running
+        static void StartBuild();
+
+        // Build again in the background (DBC inputs changed); Get waits for the new table
+        static void Rebuild();
+
+        // Publish a table built elsewhere (index cache); waits for any running build first
+        static void Adopt(std::shared_ptr<Table const> table);
+
+        // Current table. Waits for a running build and builds synchronously if none was started.
+        static std::shared_ptr<Table const> Get();
+    };
+
+} // namespace ModDynamicAH
@@ -2,44 +2,149 @@
 #include "World.h"
 #include "DatabaseEnv.h"
 #include "QueryResult.h"  // for ResultSet, Field
+#include "Log.h"
+#include "AuctionHouseMgr.h"
 
 namespace ModDynamicAH
 {
 
+    static char const *const SCARCITY_SQL =
+        "SELECT ii.itemEntry, ah.houseid, COUNT(*) "
+        "FROM auctionhouse ah JOIN item_instance ii ON ii.guid = ah.itemguid "
+        "GROUP BY ii.itemEntry, ah.houseid";
+
     void DynamicAHScarcity::Clear()
     {
-        _active.clear();
+        _active = std::make_shared<CountMap>();
+        _tracking = false;
         _online = 0;
     }
 
-    void DynamicAHScarcity::Rebuild()
+    std::shared_ptr<DynamicAHScarcity::CountMap> DynamicAHScarcity::Aggregate(QueryResult r)
     {
-        _active.clear();
-
-        if (QueryResult r = CharacterDatabase.Query(
-                "SELECT ii.itemEntry, ah.houseid, COUNT(*) "
-                "FROM auctionhouse ah JOIN item_instance ii ON ii.guid = ah.itemguid "
-                "GROUP BY ii.itemEntry, ah.houseid"))
+        auto fresh = std::make_shared<CountMap>();
+        if (r)
         {
+            fresh->reserve(size_t(r->GetRowCount()));
             do
             {
                 Field *f = r->Fetch();
                 uint32 item = f[0].Get<uint32>();
                 uint32 house = f[1].Get<uint32>();
                 uint32 cnt = f[2].Get<uint32>();
-                uint64 key = (uint64(house) << 32) | item;
-                _active[key] = cnt;
+                uint64 key = Core::ScarcityKey(Core::House(house), item);
+                (*fresh)[key].auctions = cnt;
             } while (r->NextRow());
         }
+        return fresh;
+    }
+
+    void DynamicAHScarcity::Rebuild()
+    {
+        _tracking = false;
+        _active = Aggregate(CharacterDatabase.Query(SCARCITY_SQL));
+    }
+
+    std::shared_ptr<DynamicAHScarcity::CountMap> DynamicAHScarcity::Collect(bool countUnits)
+    {
+        auto fresh = std::make_shared<CountMap>();
+        for (AuctionHouseId house : {AuctionHouseId::Alliance, AuctionHouseId::Horde, AuctionHouseId::Neutral})
+        {
+            AuctionHouseObject *ahObj = sAuctionMgr->GetAuctionsMapByHouseId(house);
+            if (!ahObj)
+                continue;
+
+            for (auto const &kv : ahObj->GetAuctions())
+            {
+                if (AuctionEntry const *A = kv.second)
+                    Core::CountAuction(*fresh, Core::House(house), A->item_template, A->itemCount, countUnits);
+            }
+        }
+        return fresh;
+    }
+
+    void DynamicAHScarcity::RebuildFromMemory(bool countUnits)
+    {
+        _countUnits = countUnits;
+        _active = Collect(countUnits);
+    }
+
+    void DynamicAHScarcity::Add(AuctionHouseId house, uint32 itemId, uint32 units)
+    {
+        if (!_tracking)
+            return;
+
+        Core::CountAuction(*_active, Core::House(house), itemId, units, _countUnits);
+    }
+
+    void DynamicAHScarcity::Remove(AuctionHouseId house, uint32 itemId, uint32 units)
+    {
+        if (!_tracking)
+            return;
+
+        auto it = _active->find(Key(house, itemId));
+        if (it == _active->end())
+            return; // added before tracking started; Verify() will settle it
+
+        Tally &t = it->second;
+        if (t.auctions <= 1)
+        {
+            _active->erase(it);
+            return;
+        }
+        --t.auctions;
+        if (_countUnits)
+        {
+            units = units ? units : 1u;
+            t.units = t.units > units ? t.units - units : 0u;
+        }
+    }
+
+    uint32 DynamicAHScarcity::Verify()
+    {
+        std::shared_ptr<CountMap> fresh = Collect(_countUnits);
+
+        uint32 drift = 0;
+        for (auto const &kv : *fresh)
+        {
+            auto it = _active->find(kv.first);
+            if (it == _active->end() || it->second.auctions != kv.second.auctions || it->second.units != kv.second.units)
+                ++drift;
+        }
+        for (auto const &kv : *_active)
+            if (!fresh->count(kv.first))
+                ++drift;
 
-        _online = static_cast<uint32>(sWorldSessionMgr->GetActiveSessionCount());
+        _active = std::move(fresh);
+        return drift;
+    }
+
+    void DynamicAHScarcity::RequestRebuild(QueryCallbackProcessor &proc)
+    {
+        if (_pending)
+            return;
+
+        _pending = true;
+        proc.AddCallback(CharacterDatabase.AsyncQuery(SCARCITY_SQL).WithCallback([this](QueryResult r)
+        {
+            // single pointer swap on the world thread; readers never see a half-built map
+            _active = Aggregate(r);
+            _tracking = false;
+            _pending = false;
+            LOG_DEBUG("mod.dynamicah", "scarcity: async rebuild swapped in {} entries", _active->size());
+        }));
     }
 
     uint32 DynamicAHScarcity::Count(uint32 itemId, AuctionHouseId house) const
     {
-        uint64 key = (uint64(uint32(house)) << 32) | itemId;
-        auto it = _active.find(key);
-        return it != _active.end() ? it->second : 0u;
+        auto it = _active->find(Key(house, itemId));
+        return it != _active->end() ? it->second.auctions : 0u;
+    }
+
+    uint32 DynamicAHScarcity::Units(uint32 itemId, AuctionHouseId house) const
+    {
+        auto it = _active->find(Key(house, itemId));
+        return it != _active->end() ? it->second.units : 0u;
     }
 
-} // namespace ModDynamicAH
\ No newline at end of file
+} // namespace ModDynamicAH
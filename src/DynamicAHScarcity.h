@@ -1,22 +1,66 @@
 #pragma once
 
 #include "DynamicAHTypes.h"
-#include "WorldSessionMgr.h"
 #include "DatabaseEnv.h"
+#include "QueryCallbackProcessor.h"
+#include "CoreInterfaces.h"
+#include "CoreScarcity.h"
+
+#include <memory>
 
 namespace ModDynamicAH
 {
 
-    class DynamicAHScarcity
+    // Active auction counts per (house, item); the planners read them as a Core::IScarcitySource
+    class DynamicAHScarcity final : public Core::IScarcitySource
     {
     public:
+        using Tally = Core::ScarcityTally;
+        using CountMap = Core::ScarcityCounts; // key = (house << 32) | itemId
+
+        // Blocking rebuild (planning worker / fallback).
         void Rebuild();
+        // Non-blocking rebuild: issues the aggregate on the async DB path. The current counts stay
+        // in use until the callback (run by `proc` on the world thread) swaps the new map in.
+        void RequestRebuild(QueryCallbackProcessor &proc);
+        bool RebuildPending() const { return _pending; }
+
+        // In-memory source: one pass over the live AuctionHouseObject maps (world thread only).
+        void RebuildFromMemory(bool countUnits);
+
+        // Incremental index fed by the auction house hooks. StartTracking() is called after a
+        // full RebuildFromMemory(); until then (and after StopTracking()) Add/Remove are ignored.
+        void StartTracking() { _tracking = true; }
+        void StopTracking() { _tracking = false; }
+        bool Tracking() const { return _tracking; }
+        void Add(AuctionHouseId house, uint32 itemId, uint32 units);
+        void Remove(AuctionHouseId house, uint32 itemId, uint32 units);
+        // Consistency check: recounts the live maps, adopts the result and returns how many
+        // (house, item) keys had drifted.
+        uint32 Verify();
+
+        // Copy for the planning worker, which must never read the live index.
+        CountMap Snapshot() const { return *_active; }
+        void Adopt(CountMap &&counts) { _active = std::make_shared<CountMap>(std::move(counts)); }
+        size_t Size() const { return _active->size(); }
+
         uint32 Count(uint32 itemId, AuctionHouseId house) const;
-        uint32 OnlineCount() const { return _online; }
+        // stacked units (sum of itemCount); only filled by the in-memory source with countUnits
+        uint32 Units(uint32 itemId, AuctionHouseId house) const;
+        uint32 OnlineCount() const override { return _online; }
+        uint32 ActiveCount(uint32 itemId, Core::House house) const override { return Count(itemId, AuctionHouseId(house)); }
+        void SetOnlineCount(uint32 online) { _online = online; }
         void Clear();
 
     private:
-        std::unordered_map<uint64, uint32> _active; // key = (house << 32) | itemId
+        static uint64 Key(AuctionHouseId house, uint32 itemId) { return Core::ScarcityKey(Core::House(house), itemId); }
+        static std::shared_ptr<CountMap> Aggregate(QueryResult r);
+        static std::shared_ptr<CountMap> Collect(bool countUnits);
+
+        std::shared_ptr<CountMap> _active = std::make_shared<CountMap>();
+        bool _pending = false;
+        bool _tracking = false;
+        bool _countUnits = false;
         uint32 _online = 0;
     };
 
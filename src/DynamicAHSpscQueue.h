@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace ModDynamicAH
+{
+
+    // Bounded lock-free single-producer/single-consumer ring.
+    // Exactly one thread may call TryPush and exactly one (other) thread may call TryPop.
+    template <typename T, size_t Capacity>
+    class SpscQueue
+    {
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    public:
+        // Producer side. Leaves v untouched and returns false when the ring is full.
+        bool TryPush(T &&v)
+        {
+            size_t const tail = _tail.load(std::memory_order_relaxed);
+            if (tail - _head.load(std::memory_order_acquire) == Capacity)
+                return false;
+            _slots[tail & (Capacity - 1)] = std::move(v);
+            _tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side. Returns false when the ring is empty.
+        bool TryPop(T &out)
+        {
+            size_t const head = _head.load(std::memory_order_relaxed);
+            if (head == _tail.load(std::memory_order_acquire))
+                return false;
+            out = std::move(_slots[head & (Capacity - 1)]);
+            _head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool Empty() const
+        {
+            return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+        }
+
+    private:
+        alignas(64) std::atomic<size_t> _head{0};
+        alignas(64) std::atomic<size_t> _tail{0};
+        std::array<T, Capacity> _slots;
+    };
+
+} // namespace ModDynamicAH
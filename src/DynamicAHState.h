@@ -17,6 +17,13 @@ namespace ModDynamicAH
         uint32_t intervalMin = 30;
         uint32_t maxRandomPerCycle = 50;
         bool loopEnabled = true;
+        uint32_t tickBudgetUs = 2000; // world-thread time a cycle may use per OnUpdate
+        bool asyncPlanning = true;    // plan on the worker thread from a snapshot
+
+        // adaptive apply rate (posts/buys per OnUpdate)
+        float applyTargetSharePct = 5.0f; // share of the world tick spent applying
+        uint32_t applyMinPerTick = 1;
+        uint32_t applyMaxPerTick = 100;
 
         // pricing & selection filters
         uint32_t minPriceCopper = 10000;
@@ -39,10 +46,16 @@ namespace ModDynamicAH
         bool scarcityEnabled = true;
         float scarcityPriceBoostMax = 0.30f;
         uint32_t scarcityPerItemPerTickCap = 1;
+        bool scarcityFromMemory = true;  // count AuctionHouseObject maps (false = SQL aggregate)
+        bool scarcityCountUnits = false; // also tally stacked units
+        uint32_t scarcityVerifyEvery = 12; // cycles between full recounts of the incremental index
 
         // vendor floor
         float vendorMinMarkup = 0.25f; // 25%
         bool vendorConsiderBuyPrice = true;
+        uint32_t vendorRefreshMin = 60; // background npc_vendor reload interval (0 = startup only)
+        std::string indexCacheFile = "dah_index.cache"; // recipe/difficulty index snapshot ("" = rebuild every start)
+        uint32_t recipeBuildThreads = 0;                // profession index scan threads (0 = hardware, max 8)
         bool neverBuyAboveVendorBuyPrice = true;
 
         // stacks & categories
@@ -60,6 +73,8 @@ namespace ModDynamicAH
 
         // debug
         bool debugContextLogs = false;
+        uint32_t logDetailPerCycle = 50; // cap on per-row decision lines per cycle (debug only)
+        bool traceEnabled = true;        // binary flight recorder (.dah trace dump)
 
         // runtime per-cycle
         struct Cycle
@@ -0,0 +1,74 @@
+#include "DynamicAHThrottle.h"
+
+#include <algorithm>
+
+namespace ModDynamicAH
+{
+
+    namespace
+    {
+        constexpr double kAlpha = 0.2;          // EWMA weight of the newest sample
+        constexpr uint32_t kUnmeasuredRate = 10; // legacy fixed batch until costs are known
+        constexpr double kMinCostUs = 0.1;      // keeps a measured cost from collapsing to 0
+
+        inline void Smooth(double &avg, double sample)
+        {
+            avg = (avg <= 0.0) ? sample : avg + kAlpha * (sample - avg);
+        }
+    }
+
+    void ApplyThrottle::Configure(float targetSharePct, uint32_t minPerTick, uint32_t maxPerTick)
+    {
+        _targetSharePct = std::clamp(targetSharePct, 0.1f, 100.0f);
+        _min = std::max<uint32_t>(1u, minPerTick);
+        _max = std::max(_min, maxPerTick);
+    }
+
+    void ApplyThrottle::ObserveTick(uint32_t diffMs)
+    {
+        if (diffMs)
+            Smooth(_tickMs, double(diffMs));
+    }
+
+    uint64_t ApplyThrottle::BudgetUs() const
+    {
+        return uint64_t(_tickMs * 1000.0 * double(_targetSharePct) / 100.0);
+    }
+
+    uint32_t ApplyThrottle::Rate(uint64_t budgetUs, double costUs) const
+    {
+        if (costUs <= 0.0 || _tickMs <= 0.0)
+            return std::clamp(kUnmeasuredRate, _min, _max);
+
+        double n = double(budgetUs) / costUs;
+        if (n >= double(_max))
+            return _max;
+        return std::max(_min, uint32_t(n));
+    }
+
+    uint32_t ApplyThrottle::PostQuota() const
+    {
+        return Rate(BudgetUs(), _postCostUs);
+    }
+
+    uint32_t ApplyThrottle::BuyQuota(uint64_t postElapsedUs) const
+    {
+        uint64_t budget = BudgetUs();
+        return Rate(budget > postElapsedUs ? budget - postElapsedUs : 0, _buyCostUs);
+    }
+
+    void ApplyThrottle::ObservePosts(uint32_t applied, uint64_t elapsedUs)
+    {
+        _lastPosts = applied;
+        if (applied)
+            Smooth(_postCostUs, std::max(kMinCostUs, double(elapsedUs) / double(applied)));
+    }
+
+    void ApplyThrottle::ObserveBuys(uint32_t applied, uint64_t elapsedUs)
+    {
+        _lastBuys = applied;
+        if (applied)
+            Smooth(_buyCostUs, std::max(kMinCostUs, double(elapsedUs) / double(applied)));
+    }
+
+} // namespace ModDynamicAH
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+
+namespace ModDynamicAH
+{
+
+    // Adaptive apply rate: sizes each tick's post/buy batches so that applying them costs
+    // roughly targetSharePct of the measured world tick. Costs are EWMA-smoothed per op.
+    class ApplyThrottle
+    {
+    public:
+        void Configure(float targetSharePct, uint32_t minPerTick, uint32_t maxPerTick);
+
+        // Feed the `diff` passed to WorldScript::OnUpdate.
+        void ObserveTick(uint32_t diffMs);
+
+        // Batch sizes for this tick. Posts are applied first; buys get what is left.
+        uint32_t PostQuota() const;
+        uint32_t BuyQuota(uint64_t postElapsedUs) const;
+
+        // Feed what one apply call did and how long it took (wall clock).
+        void ObservePosts(uint32_t applied, uint64_t elapsedUs);
+        void ObserveBuys(uint32_t applied, uint64_t elapsedUs);
+
+        // readouts
+        uint32_t LastPosts() const { return _lastPosts; }
+        uint32_t LastBuys() const { return _lastBuys; }
+        double TickMs() const { return _tickMs; }
+        double PostCostUs() const { return _postCostUs; }
+        double BuyCostUs() const { return _buyCostUs; }
+        uint64_t BudgetUs() const;
+        float TargetSharePct() const { return _targetSharePct; }
+        uint32_t MinPerTick() const { return _min; }
+        uint32_t MaxPerTick() const { return _max; }
+
+    private:
+        uint32_t Rate(uint64_t budgetUs, double costUs) const;
+
+        float _targetSharePct = 5.0f;
+        uint32_t _min = 1;
+        uint32_t _max = 100;
+
+        double _tickMs = 0.0;     // smoothed tick length
+        double _postCostUs = 0.0; // smoothed cost per post, 0 = not measured yet
+        double _buyCostUs = 0.0;  // smoothed cost per buy, 0 = not measured yet
+
+        uint32_t _lastPosts = 0;
+        uint32_t _lastBuys = 0;
+    };
+
+} // namespace ModDynamicAH
@@ -0,0 +1,110 @@
+#include "DynamicAHTrace.h"
+#include "ModDynamicAHBuy.h" // reason names
+#include "Log.h"
+
+#include <chrono>
+#include <fstream>
+
+namespace ModDynamicAH
+{
+
+    FlightRecorder::Slot FlightRecorder::_ring[FlightRecorder::kCapacity];
+    std::atomic<uint64> FlightRecorder::_next{0};
+    std::atomic<bool> FlightRecorder::_enabled{true};
+
+    void FlightRecorder::Record(TraceStage stage, uint8 reason, AuctionHouseId house, uint32 itemId, uint32 aux,
+                                uint32 priceA, uint32 priceB, float margin)
+    {
+        if (!Enabled())
+            return;
+
+        uint64 idx = _next.fetch_add(1, std::memory_order_relaxed);
+        Slot &s = _ring[idx & (kCapacity - 1)];
+
+        s.seq.store(0, std::memory_order_relaxed); // mark torn while rewriting
+        std::atomic_thread_fence(std::memory_order_release);
+
+        TraceRecord &r = s.rec;
+        r.timeMs = uint64(std::chrono::duration_cast<std::chrono::milliseconds>(
+                              std::chrono::system_clock::now().time_since_epoch())
+                              .count());
+        r.aux = aux;
+        r.itemId = itemId;
+        r.priceA = priceA;
+        r.priceB = priceB;
+        float bp = margin * 10000.0f;
+        r.marginBp = int16(bp > 32767.0f ? 32767.0f : bp < -32768.0f ? -32768.0f : bp);
+        r.house = uint8(house);
+        r.stage = uint8(stage);
+        r.reason = reason;
+
+        s.seq.store(idx + 1, std::memory_order_release);
+    }
+
+    static char const *StageName(uint8 stage)
+    {
+        switch (TraceStage(stage))
+        {
+        case TraceStage::Price:
+            return "price";
+        case TraceStage::BuyPlan:
+            return "buyplan";
+        case TraceStage::BuyApply:
+            return "buyapply";
+        case TraceStage::Post:
+            return "post";
+        default:
+            return "?";
+        }
+    }
+
+    static std::string ReasonName(uint8 stage, uint8 reason)
+    {
+        switch (TraceStage(stage))
+        {
+        case TraceStage::Price:
+            return "family=" + std::to_string(reason);
+        case TraceStage::BuyPlan:
+            return reason < BuyReasonNames.size() ? BuyReasonNames[reason] : "?";
+        case TraceStage::BuyApply:
+            return reason < ApplyReasonNames.size() ? ApplyReasonNames[reason] : "?";
+        case TraceStage::Post:
+            return reason == uint8(TracePostResult::Posted) ? "posted" : reason == uint8(TracePostResult::Failed) ? "failed"
+                                                                                                                   : "dry-run";
+        default:
+            return "?";
+        }
+    }
+
+    int64 FlightRecorder::DumpToFile(std::string const &path)
+    {
+        std::ofstream out(path, std::ios::trunc);
+        if (!out)
+            return -1;
+
+        out << "# timeMs stage reason house item aux priceA priceB marginBp\n";
+
+        uint64 end = _next.load(std::memory_order_acquire);
+        uint64 begin = end > kCapacity ? end - kCapacity : 0;
+        int64 written = 0;
+        for (uint64 idx = begin; idx < end; ++idx)
+        {
+            Slot const &s = _ring[idx & (kCapacity - 1)];
+            if (s.seq.load(std::memory_order_acquire) != idx + 1)
+                continue; // overwritten or still being written
+            TraceRecord r = s.rec;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (s.seq.load(std::memory_order_relaxed) != idx + 1)
+                continue;
+
+            out << r.timeMs << ' ' << StageName(r.stage) << ' ' << ReasonName(r.stage, r.reason) << ' '
+                << uint32(r.house) << ' ' << r.itemId << ' ' << r.aux << ' ' << r.priceA << ' ' << r.priceB << ' '
+                << r.marginBp << '\n';
+            ++written;
+        }
+
+        LOG_INFO("mod.dynamicah", "trace: dumped {} records to {}", written, path);
+        return written;
+    }
+
+} // namespace ModDynamicAH
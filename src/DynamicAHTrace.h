@@ -0,0 +1,73 @@
+#pragma once
+
+#include "DynamicAHTypes.h"
+
+#include <atomic>
+#include <string>
+
+namespace ModDynamicAH
+{
+
+    enum class TraceStage : uint8
+    {
+        Price,    // PriceWithPolicies; reason = Family, aux = active auctions
+        BuyPlan,  // buy scan decision; reason = BuyReason
+        BuyApply, // buyout execution; reason = ApplyReason
+        Post,     // ApplyPlanOnWorld; reason = TracePostResult
+    };
+
+    enum class TracePostResult : uint8
+    {
+        Posted,
+        Failed,
+        DryRun,
+    };
+
+    // 32 bytes, written in place; no strings, no allocation.
+    struct TraceRecord
+    {
+        uint64 timeMs = 0; // wall clock, ms since epoch
+        uint32 aux = 0;    // auction id (buy), active count (price), stack count (post)
+        uint32 itemId = 0;
+        uint32 priceA = 0; // price: unit start | buy: unit ask  | post: stack start
+        uint32 priceB = 0; // price: unit buy   | buy: fair unit | post: stack buyout
+        int16 marginBp = 0; // buy margin in basis points
+        uint8 house = 0;
+        uint8 stage = 0;
+        uint8 reason = 0;
+        uint8 pad[3] = {};
+    };
+    static_assert(sizeof(TraceRecord) == 32, "TraceRecord should stay one half cache line");
+
+    // Fixed-size ring of the most recent decisions. Record() is wait-free and safe from the
+    // world thread and the planning worker at once; old records are overwritten.
+    class FlightRecorder
+    {
+    public:
+        static constexpr size_t kCapacity = size_t(1) << 16;
+
+        static void SetEnabled(bool on) { _enabled.store(on, std::memory_order_relaxed); }
+        static bool Enabled() { return _enabled.load(std::memory_order_relaxed); }
+
+        static void Record(TraceStage stage, uint8 reason, AuctionHouseId house, uint32 itemId, uint32 aux,
+                           uint32 priceA, uint32 priceB, float margin = 0.0f);
+
+        // Records ever written (may exceed kCapacity)
+        static uint64 Written() { return _next.load(std::memory_order_relaxed); }
+
+        // Decodes the buffer, oldest first, to a text file. Returns records written or -1.
+        static int64 DumpToFile(std::string const &path);
+
+    private:
+        struct Slot
+        {
+            std::atomic<uint64> seq{0}; // 1 + write index once the record is complete
+            TraceRecord rec;
+        };
+
+        static Slot _ring[kCapacity];
+        static std::atomic<uint64> _next;
+        static std::atomic<bool> _enabled;
+    };
+
+} // namespace ModDynamicAH
@@ -5,6 +5,8 @@
 #include "SharedDefines.h"
 #include "ItemTemplate.h"
 #include "AuctionHouseMgr.h"
+#include "CorePostQueue.h"
+#include "CoreTypes.h"
 
 #include <cstdint>
 #include <string>
@@ -15,30 +17,9 @@
 namespace ModDynamicAH
 {
 
-    // --- Families (crafting categories) ---
-    enum class Family : uint8
-    {
-        Herb,
-        Ore,
-        Bar,
-        Cloth,
-        Leather,
-        Jewelcrafting,
-        Dust,
-        Essence,
-        Shard,
-        Elemental,
-        Stone,
-        Meat,
-        Fish,
-        Gem,
-        Bandage,
-        Potion,
-        Ink,
-        Pigment,
-        Other,
-        COUNT
-    };
+    // --- Families (crafting categories) and material pricing categories ---
+    using Core::Family;
+    using Core::MatCategory;
 
     inline char const *FamilyName(Family f)
     {
@@ -84,6 +65,8 @@ namespace ModDynamicAH
     }
 
     // --- Post queue (for auction postings) ---
+    using Core::PostLane;
+
     struct PostRequest
     {
         AuctionHouseId house = AuctionHouseId::Neutral;
@@ -92,28 +75,39 @@ namespace ModDynamicAH
         uint32 startBid = 0;
         uint32 buyout = 0;
         uint32 duration = 12 * HOUR;
+        PostLane lane = PostLane::Context;
     };
 
-    class PostQueue
+    // --- Auction snapshot row (plain copy of what the planners read from an AuctionEntry) ---
+    struct AuctionRow
     {
-    public:
-        void Push(PostRequest r) { _q.emplace_back(std::move(r)); }
-        std::vector<PostRequest> Drain(uint32 max)
-        {
-            if (max == 0 || _q.empty())
-                return {};
-            uint32 take = std::min<uint32>(max, uint32(_q.size()));
-            std::vector<PostRequest> out(_q.begin(), _q.begin() + take);
-            _q.erase(_q.begin(), _q.begin() + take);
-            return out;
-        }
-        uint32 Size() const { return uint32(_q.size()); }
-        void Clear() { _q.clear(); }
-
-    private:
-        std::vector<PostRequest> _q;
+        uint32 id = 0;
+        AuctionHouseId house = AuctionHouseId::Neutral;
+        uint32 itemId = 0;
+        uint32 count = 1;
+        uint32 startBid = 0;
+        uint32 buyout = 0;
+        uint32 owner = 0; // owner character guid (low part)
+        bool hasBidder = false;
     };
 
+    inline AuctionRow MakeAuctionRow(AuctionEntry const &a)
+    {
+        AuctionRow r;
+        r.id = a.Id;
+        r.house = a.houseId;
+        r.itemId = a.item_template;
+        r.count = a.itemCount ? a.itemCount : 1u;
+        r.startBid = a.startbid;
+        r.buyout = a.buyout;
+        r.owner = a.owner.GetCounter();
+        r.hasBidder = !a.bidder.IsEmpty();
+        return r;
+    }
+
+    // FIFO per lane; lanes drain in PostLane order.
+    using PostQueue = Core::LaneQueue<PostRequest>;
+
     // --- Config keys (one place) ---
     inline constexpr char const *CFG_ENABLE_SELLER = "ModDynamicAH.EnableSeller";
     inline constexpr char const *CFG_DRYRUN = "ModDynamicAH.DryRun";
@@ -136,8 +130,14 @@ namespace ModDynamicAH
     inline constexpr char const *CFG_SCARCITY_ENABLED = "ModDynamicAH.Scarcity.Enabled";
     inline constexpr char const *CFG_SCARCITY_PRICE_BOOST_MAX = "ModDynamicAH.Scarcity.PriceBoostMax";
     inline constexpr char const *CFG_SCARCITY_PER_TICK_ITEM_CAP = "ModDynamicAH.Scarcity.PerItemCap";
+    inline constexpr char const *CFG_SCARCITY_FROM_MEMORY = "ModDynamicAH.Scarcity.FromMemory";
+    inline constexpr char const *CFG_SCARCITY_COUNT_UNITS = "ModDynamicAH.Scarcity.CountUnits";
+    inline constexpr char const *CFG_SCARCITY_VERIFY_EVERY = "ModDynamicAH.Scarcity.VerifyEveryCycles";
     inline constexpr char const *CFG_VENDOR_MIN_MARKUP = "ModDynamicAH.Vendor.MinMarkup";
     inline constexpr char const *CFG_VENDOR_CONSIDER_BUYPRICE = "ModDynamicAH.Vendor.ConsiderBuyPrice";
+    inline constexpr char const *CFG_VENDOR_REFRESH_MIN = "ModDynamicAH.Vendor.RefreshMinutes";
+    inline constexpr char const *CFG_INDEX_CACHE_FILE = "ModDynamicAH.IndexCache.File";
+    inline constexpr char const *CFG_RECIPE_BUILD_THREADS = "ModDynamicAH.Recipes.BuildThreads";
 
     inline constexpr char const *CFG_STACK_DEFAULT = "ModDynamicAH.Stack.Default";
     inline constexpr char const *CFG_STACK_CLOTH = "ModDynamicAH.Stack.Cloth";
@@ -166,7 +166,14 @@ namespace ModDynamicAH
     inline constexpr char const *CFG_PRICE_MUL_RARERAW = "ModDynamicAH.PriceMul.RareRaw";
 
     inline constexpr char const *CFG_DEBUG_CONTEXT_LOGS = "ModDynamicAH.Context.DebugLogs";
+    inline constexpr char const *CFG_LOG_DETAIL_PER_CYCLE = "ModDynamicAH.Log.DetailPerCycle";
+    inline constexpr char const *CFG_TRACE_ENABLED = "ModDynamicAH.Trace.Enabled";
     inline constexpr char const *CFG_LOOP_ENABLED = "ModDynamicAH.Loop.Enabled";
+    inline constexpr char const *CFG_CYCLE_TICK_BUDGET_US = "ModDynamicAH.Cycle.TickBudgetUs";
+    inline constexpr char const *CFG_PLANNER_ASYNC = "ModDynamicAH.Planner.Async";
+    inline constexpr char const *CFG_APPLY_TARGET_SHARE = "ModDynamicAH.Apply.TargetTickSharePct";
+    inline constexpr char const *CFG_APPLY_MIN_PER_TICK = "ModDynamicAH.Apply.MinPerTick";
+    inline constexpr char const *CFG_APPLY_MAX_PER_TICK = "ModDynamicAH.Apply.MaxPerTick";
 
     // economy
     inline constexpr char const *CFG_ECON_GOLD_PER_QUEST = "ModDynamicAH.Econ.AvgGoldPerQuest";
@@ -207,6 +214,7 @@ namespace ModDynamicAH
     inline constexpr char const *CFG_BUY_PER_ITEM_CAP = "ModDynamicAH.Buy.PerItemPerCycleCap";
     inline constexpr char const *CFG_BUY_MAX_SCAN_ROWS = "ModDynamicAH.Buy.MaxScanRows";
     inline constexpr char const *CFG_BUY_BLOCK_TRASH_COMMON = "ModDynamicAH.Buy.BlockTrashAndCommon";
+    inline constexpr char const *CFG_BUY_DEBUG = "ModDynamicAH.Buy.Debug";
 
     // Parses a comma/space separated list of uint32s into a set
     inline std::unordered_set<uint32_t> ParseCsvU32(std::string const &csv)
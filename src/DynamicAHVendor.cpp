@@ -3,48 +3,81 @@
 #include "ObjectMgr.h"
 #include "QueryResult.h"
 #include "Field.h"
+#include "Log.h"
+
+#include <atomic>
 
 namespace ModDynamicAH
 {
 
-    static std::unordered_map<uint32, uint8> g_vendorCache;
-    std::unordered_map<uint32, uint8> &DynamicAHVendor::Cache() { return g_vendorCache; }
+    // MIN(maxcount): one unlimited vendor is enough to call the item unlimited.
+    // Negative items are vendor reference entries, not items.
+    static char const *const VENDOR_SQL =
+        "SELECT item, MIN(maxcount) FROM npc_vendor WHERE item > 0 GROUP BY item";
 
-    uint8 DynamicAHVendor::VendorStockType(uint32 itemId, ItemTemplate const *tmpl, bool considerBuyPrice)
-    {
-        auto it = g_vendorCache.find(itemId);
-        if (it != g_vendorCache.end())
-            return it->second;
+    // Published as a whole; the planning worker may read it while a refresh lands.
+    static std::shared_ptr<std::vector<uint8> const> g_vendorStock;
+    static bool g_vendorRefreshPending = false;
 
-        uint8 res = 0;
+    std::shared_ptr<DynamicAHVendor::StockTable const> DynamicAHVendor::BuildIndex(QueryResult r)
+    {
+        auto table = std::make_shared<StockTable>();
+        if (!r)
+            return table;
 
-        if (QueryResult qr = WorldDatabase.Query("SELECT maxcount FROM npc_vendor WHERE item = {} LIMIT 1", itemId))
+        std::vector<std::pair<uint32, int32>> rows;
+        rows.reserve(size_t(r->GetRowCount()));
+        uint32 maxId = 0;
+        do
         {
-            int32 maxc = qr->Fetch()[0].Get<int32>(); // 0 = unlimited, >0 = limited
-            res = (maxc == 0) ? 2 : 1;
-        }
-        else if (considerBuyPrice && tmpl && tmpl->BuyPrice > 0)
-            res = 2;
-
-        g_vendorCache.emplace(itemId, res);
-        return res;
+            Field *f = r->Fetch();
+            uint32 item = f[0].Get<uint32>();
+            rows.emplace_back(item, f[1].Get<int32>());
+            maxId = std::max(maxId, item);
+        } while (r->NextRow());
+
+        table->assign(size_t(maxId) + 1, 0);
+        for (auto const &row : rows)
+            (*table)[row.first] = (row.second == 0) ? 2 : 1; // 0 = unlimited, >0 = limited
+        return table;
+    }
+
+    void DynamicAHVendor::LoadIndex()
+    {
+        auto table = BuildIndex(WorldDatabase.Query(VENDOR_SQL));
+        LOG_INFO("mod.dynamicah", "vendor: indexed npc_vendor (max item id {})", table->empty() ? 0 : table->size() - 1);
+        std::atomic_store(&g_vendorStock, table);
     }
 
-    void DynamicAHVendor::ApplyVendorFloor(ItemTemplate const *tmpl, uint32 &startBid, uint32 &buyout, uint32 minPriceCopper, double vendorMinMarkup)
+    void DynamicAHVendor::RequestRefresh(QueryCallbackProcessor &proc, std::function<void()> onSwap)
     {
-        if (!tmpl)
+        if (g_vendorRefreshPending)
             return;
 
-        if (tmpl->BuyPrice == 0)
+        g_vendorRefreshPending = true;
+        proc.AddCallback(WorldDatabase.AsyncQuery(VENDOR_SQL).WithCallback([onSwap = std::move(onSwap)](QueryResult r)
         {
-            startBid = std::max(startBid, minPriceCopper);
-            buyout = std::max(buyout, std::max(startBid, minPriceCopper));
-            return;
-        }
+            std::atomic_store(&g_vendorStock, BuildIndex(r));
+            g_vendorRefreshPending = false;
+            if (onSwap)
+                onSwap();
+        }));
+    }
+
+    bool DynamicAHVendor::Loaded()
+    {
+        return std::atomic_load(&g_vendorStock) != nullptr;
+    }
+
+    uint8 DynamicAHVendor::VendorStockType(uint32 itemId, ItemTemplate const *tmpl, bool considerBuyPrice)
+    {
+        std::shared_ptr<StockTable const> table = std::atomic_load(&g_vendorStock);
+        if (table && itemId < table->size() && (*table)[itemId])
+            return (*table)[itemId];
 
-        uint32 floorV = std::max<uint32>(minPriceCopper, uint32(double(tmpl->BuyPrice) * (1.0 + vendorMinMarkup)));
-        startBid = std::max(startBid, floorV);
-        buyout = std::max(buyout, std::max(startBid, floorV));
+        if (considerBuyPrice && tmpl && tmpl->BuyPrice > 0)
+            return 2;
+        return 0;
     }
 
 } // namespace ModDynamicAH
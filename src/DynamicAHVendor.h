@@ -3,6 +3,10 @@
 #include "DynamicAHTypes.h"
 #include "DatabaseEnv.h"
 #include "ObjectMgr.h"
+#include "QueryCallbackProcessor.h"
+
+#include <functional>
+#include <memory>
 
 namespace ModDynamicAH
 {
@@ -10,12 +14,20 @@ namespace ModDynamicAH
     class DynamicAHVendor
     {
     public:
-        // 0 = not vendor, 1 = limited stock, 2 = unlimited
+        // 0 = not vendor, 1 = limited stock, 2 = unlimited. Reads the bulk-loaded index only.
         static uint8 VendorStockType(uint32 itemId, ItemTemplate const *tmpl, bool considerBuyPrice);
-        static void ApplyVendorFloor(ItemTemplate const *tmpl, uint32 &startBid, uint32 &buyout, uint32 minPriceCopper, double vendorMinMarkup);
+
+        // Whole npc_vendor table in one query. LoadIndex blocks (startup); RequestRefresh goes
+        // through the async DB path and swaps the new table in from `proc` on the world thread,
+        // then runs onSwap.
+        static void LoadIndex();
+        static void RequestRefresh(QueryCallbackProcessor &proc, std::function<void()> onSwap = nullptr);
+        static bool Loaded();
 
     private:
-        static std::unordered_map<uint32, uint8> &Cache();
+        using StockTable = std::vector<uint8>; // dense, indexed by item id
+
+        static std::shared_ptr<StockTable const> BuildIndex(QueryResult r);
     };
 
 } // namespace ModDynamicAH
@@ -0,0 +1,118 @@
+#include "DynamicAHWorker.h"
+#include "DynamicAHCycle.h"
+#include "Log.h"
+
+namespace ModDynamicAH
+{
+
+    void PlanningWorker::Start()
+    {
+        if (_thread.joinable())
+            return;
+
+        _stop.store(false, std::memory_order_release);
+        _thread = std::thread(&PlanningWorker::Run, this);
+        LOG_INFO("mod.dynamicah", "worker: planning thread started");
+    }
+
+    uint32 PlanningWorker::Stop()
+    {
+        if (!_thread.joinable())
+            return 0;
+
+        _stop.store(true, std::memory_order_release);
+        Wake();
+        _thread.join();
+
+        // the thread is gone, so the world thread may consume both rings now
+        uint32 dropped = 0;
+        std::unique_ptr<PlanJob> job;
+        while (_jobs.TryPop(job))
+            ++dropped;
+        std::unique_ptr<PlanResult> res;
+        while (_results.TryPop(res))
+            ++dropped;
+
+        LOG_INFO("mod.dynamicah", "worker: planning thread stopped ({} pending plans discarded)", dropped);
+        return dropped;
+    }
+
+    void PlanningWorker::Wake()
+    {
+        // taking the lock orders the wake after the thread's predicate check, so none is lost
+        {
+            std::lock_guard<std::mutex> lock(_wakeLock);
+        }
+        _wake.notify_one();
+    }
+
+    bool PlanningWorker::Submit(std::unique_ptr<PlanJob> &&job)
+    {
+        if (!_jobs.TryPush(std::move(job)))
+            return false;
+        Wake();
+        return true;
+    }
+
+    std::unique_ptr<PlanResult> PlanningWorker::Poll()
+    {
+        std::unique_ptr<PlanResult> res;
+        if (_results.TryPop(res))
+            Wake(); // a result slot is free again
+        return res;
+    }
+
+    void PlanningWorker::Run()
+    {
+        auto stopping = [this]
+        { return _stop.load(std::memory_order_acquire); };
+
+        while (!stopping())
+        {
+            std::unique_ptr<PlanJob> job;
+            {
+                std::unique_lock<std::mutex> lock(_wakeLock);
+                _wake.wait(lock, [&]
+                           { return stopping() || _jobs.TryPop(job); });
+            }
+            if (!job)
+                return;
+
+            std::unique_ptr<PlanResult> res = Plan(*job);
+            std::unique_lock<std::mutex> lock(_wakeLock);
+            _wake.wait(lock, [&]
+                       { return stopping() || _results.TryPush(std::move(res)); });
+        }
+    }
+
+    std::unique_ptr<PlanResult> PlanningWorker::Plan(PlanJob &job)
+    {
+        TickBudget clock = TickBudget::Unlimited();
+        auto res = std::make_unique<PlanResult>();
+        res->cycleId = job.cycleId;
+
+        // ---- sell side ----
+        _clock.Set(job.nowMs);
+        if (job.planner.scarcityFromMemory)
+            _planner.AdoptScarcity(std::move(job.scarcity), job.onlineCount);
+        else
+            _planner.BuildScarcityCache(job.onlineCount);
+        _planner.BuildContextPlan(job.planner);
+        _planner.BuildRandomPlan(job.planner);
+        res->posts = _planner.Queue().Drain(UINT32_MAX);
+
+        // ---- buy side ----
+        _buy.SetConfig(job.buy);
+        _buy.SetFilters(job.allowQuality, job.whiteAllow);
+        _buy.ResetCycle();
+
+        DefaultBuyPolicy policy{_planner.Scarcity(), job.buy.onlineCount, job.buy.minPriceCopper};
+        _buy.BuildPlanFromRows(job.auctions, policy);
+        res->buyBudgetUsed = _buy.BudgetUsed();
+        res->buys = _buy.TakePlan();
+
+        res->elapsedUs = clock.ElapsedUs();
+        return res;
+    }
+
+} // namespace ModDynamicAH
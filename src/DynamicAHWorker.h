@@ -0,0 +1,82 @@
+#pragma once
+
+#include "DynamicAHTypes.h"
+#include "DynamicAHPlanner.h"
+#include "DynamicAHSpscQueue.h"
+#include "ModDynamicAHBuy.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ModDynamicAH
+{
+
+    // Everything one planning cycle reads, copied on the world thread.
+    // Item templates are referenced, not copied: the core never mutates them after startup.
+    struct PlanJob
+    {
+        uint32 cycleId = 0;
+        PlannerConfig planner;
+        BuyEngineConfig buy;
+        bool allowQuality[6] = {false, false, true, true, true, false};
+        std::unordered_set<uint32> whiteAllow;
+        uint32 onlineCount = 0;
+        // copy of the world thread's scarcity index (in-memory source only)
+        DynamicAHScarcity::CountMap scarcity;
+        std::vector<Core::AuctionFacts> auctions; // scan order A, H, N; ascending id per house
+        uint64 nowMs = 0; // game time of the snapshot (seeds the random plan)
+    };
+
+    struct PlanResult
+    {
+        uint32 cycleId = 0;
+        std::vector<PostRequest> posts;
+        std::vector<BuyEngine::BuyCandidate> buys;
+        uint64 buyBudgetUsed = 0;
+        uint64 elapsedUs = 0;
+    };
+
+    // Dedicated planning thread. The world thread submits snapshots and drains results;
+    // both directions go through lock-free SPSC rings, so OnUpdate never blocks on it. The
+    // thread sleeps on a condition variable while it has nothing to plan or nowhere to put
+    // a result; Submit and Poll wake it.
+    class PlanningWorker
+    {
+    public:
+        ~PlanningWorker() { Stop(); }
+
+        void Start();
+        // Joins the thread and discards any job or result still queued (setting turned off or
+        // shutdown); returns how many were dropped
+        uint32 Stop();
+        bool Running() const { return _thread.joinable(); }
+        // counters only; safe from the world thread
+        PriceCacheStats PriceStats() const { return _planner.PriceStats(); }
+
+        // world thread only
+        bool Submit(std::unique_ptr<PlanJob> &&job);
+        std::unique_ptr<PlanResult> Poll();
+
+    private:
+        void Run();
+        std::unique_ptr<PlanResult> Plan(PlanJob &job);
+        void Wake();
+
+        SpscQueue<std::unique_ptr<PlanJob>, 4> _jobs;
+        SpscQueue<std::unique_ptr<PlanResult>, 4> _results;
+        std::thread _thread;
+        std::atomic<bool> _stop{false};
+        std::mutex _wakeLock;
+        std::condition_variable _wake;
+
+        // worker-owned; never touched by the world thread
+        CapturedClock _clock;
+        DynamicAHPlanner _planner{_clock};
+        BuyEngine _buy;
+    };
+
+} // namespace ModDynamicAH
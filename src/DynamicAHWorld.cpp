@@ -20,6 +20,33 @@ void DynamicAHWorld::OnUpdate(uint32 diff)
     Service::Instance().OnUpdate(diff);
 }
 
+void DynamicAHWorld::OnShutdown()
+{
+    Service::Instance().OnShutdown();
+}
+
+DynamicAHAuctionHooks::DynamicAHAuctionHooks() : AuctionHouseScript("DynamicAHAuctionHooks") {}
+
+void DynamicAHAuctionHooks::OnAuctionAdd(AuctionHouseObject * /*ah*/, AuctionEntry *entry)
+{
+    Service::Instance().OnAuctionAdd(entry);
+}
+
+void DynamicAHAuctionHooks::OnAuctionRemove(AuctionHouseObject * /*ah*/, AuctionEntry *entry)
+{
+    Service::Instance().OnAuctionRemove(entry);
+}
+
+void DynamicAHAuctionHooks::OnAuctionSuccessful(AuctionHouseObject * /*ah*/, AuctionEntry *entry)
+{
+    Service::Instance().OnAuctionSold(entry);
+}
+
+void DynamicAHAuctionHooks::OnAuctionExpire(AuctionHouseObject * /*ah*/, AuctionEntry *entry)
+{
+    Service::Instance().OnAuctionExpired(entry);
+}
+
 uint64 DynamicAHWorld::NowMs()
 {
     return NowMsInternal();
@@ -60,13 +87,36 @@ bool DynamicAHWorld::HandleStatus(ChatHandler *handler)
     auto &s = Service::Instance().State();
     if (handler)
     {
-        handler->PSendSysMessage("ModDynamicAH: loop={} dryrun={} intervalMin={} nextRunMs={} queuedPosts={} queuedBuys={}",
+        handler->PSendSysMessage("ModDynamicAH: loop={} dryrun={} intervalMin={} nextRunMs={} stage={} budget={}us queuedPosts={} queuedBuys={}",
                                  s.loopEnabled ? "ON" : "OFF",
                                  s.dryRun ? "ON" : "OFF",
                                  s.intervalMin,
                                  (unsigned long long)s.nextRunMs,
+                                 Service::Instance().StageLabel(),
+                                 s.tickBudgetUs,
                                  s.postQueue.Size(),
                                  Service::Instance().Buy().QueueSize());
+
+        ApplyThrottle const &t = Service::Instance().Throttle();
+        handler->PSendSysMessage("ModDynamicAH: apply posts/tick={} buys/tick={} (target {:.1f}% of {:.1f}ms tick = {}us, min={} max={}; cost post={:.1f}us buy={:.1f}us)",
+                                 t.PostQuota(), t.BuyQuota(0),
+                                 double(t.TargetSharePct()), t.TickMs(), t.BudgetUs(),
+                                 t.MinPerTick(), t.MaxPerTick(),
+                                 t.PostCostUs(), t.BuyCostUs());
+
+        DynamicAHScarcity const &sc = Service::Instance().Planner().Scarcity();
+        handler->PSendSysMessage("ModDynamicAH: scarcity source={} tracking={} keys={} sold={} expired={}",
+                                 s.scarcityFromMemory ? "memory" : "sql",
+                                 sc.Tracking() ? "ON" : "OFF",
+                                 sc.Size(),
+                                 Service::Instance().AuctionsSold(),
+                                 Service::Instance().AuctionsExpired());
+
+        PriceCacheStats pc = Service::Instance().PriceStats();
+        uint64 lookups = pc.hits + pc.misses;
+        handler->PSendSysMessage("ModDynamicAH: price cache hits={} misses={} ({:.1f}% hit) flushes={}",
+                                 pc.hits, pc.misses, lookups ? 100.0 * double(pc.hits) / double(lookups) : 0.0,
+                                 pc.flushes);
     }
     return true;
 }
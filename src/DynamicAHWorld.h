@@ -20,8 +20,20 @@ namespace ModDynamicAH
         static bool HandleStatus(ChatHandler* handler);
         void OnAfterConfigLoad(bool /*reload*/) override;
         void OnUpdate(uint32 diff) override;
+        void OnShutdown() override;
 
     private:
         static uint64 NowMs();
     };
+
+    // Feeds auction house events to the incremental scarcity index
+    class DynamicAHAuctionHooks : public AuctionHouseScript
+    {
+    public:
+        DynamicAHAuctionHooks();
+        void OnAuctionAdd(AuctionHouseObject *ah, AuctionEntry *entry) override;
+        void OnAuctionRemove(AuctionHouseObject *ah, AuctionEntry *entry) override;
+        void OnAuctionSuccessful(AuctionHouseObject *ah, AuctionEntry *entry) override;
+        void OnAuctionExpire(AuctionHouseObject *ah, AuctionEntry *entry) override;
+    };
 } // namespace ModDynamicAH
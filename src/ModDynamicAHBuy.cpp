@@ -6,6 +6,11 @@
 #include "AuctionHouseMgr.h" // AuctionHouseObject, AuctionEntry, sAuctionMgr
 #include "SharedDefines.h"
 #include "Log.h"   // ITEM_CLASS_TRADE_GOODS
+#include "DatabaseEnv.h"
+#include "ObjectAccessor.h"
+#include "Player.h"
+#include "ScriptMgr.h"
+#include "DynamicAHTrace.h"
 
 using namespace ModDynamicAH;
 
@@ -30,279 +35,379 @@ static inline std::string MoneyShort(uint32 copper)
 
 void BuyEngine::SetFilters(bool allowQuality[6], std::unordered_set<uint32_t> const &whiteAllow)
 {
+    Core::BuyQualityFilter filter;
     for (int i = 0; i < 6; ++i)
-        _allowQuality[i] = allowQuality[i];
-    _whiteAllow = whiteAllow;
+        filter.allowQuality[i] = allowQuality[i];
+    filter.whiteAllow = whiteAllow;
+    _plan.SetFilter(filter);
 }
 
 void BuyEngine::ResetCycle()
 {
+    _finishApply();
     _queue.clear();
-    _perItemCount.clear();
-    _budgetUsed = 0;
+    _applyNext = 0;
+    _plan.Ledger().Reset();
+    _funds.clear();
+    ++_fundsGen;
+    _fundsPending = false;
 }
 
-bool BuyEngine::_qualityAllowed(uint32_t itemId) const
+// -------------------------------------------------------------------------------------------------
+// Planning (scan in-memory auctions; no SQL)
+// -------------------------------------------------------------------------------------------------
+
+void BuyEngine::BuildPlan(
+    Core::IAuctionSource &source,
+    std::function<uint32_t(uint32_t, AuctionHouseId)> scarceFn,
+    std::function<PricingResult(uint32_t, uint32_t)> fairFn,
+    std::function<std::pair<bool, uint32_t>(uint32_t)> vendorFn)
 {
-    ItemTemplate const *t = sObjectMgr->GetItemTemplate(itemId);
-    if (!t)
-        return false;
+    BeginPlan();
+    PlanStep(source, scarceFn, fairFn, vendorFn, TickBudget::Unlimited());
+}
 
-    // Always allow explicitly allow-listed white/gray items
-    if (t->Quality <= ITEM_QUALITY_NORMAL && _whiteAllow.find(itemId) != _whiteAllow.end())
-        return true;
+void BuyEngine::_beginPlan()
+{
+    _planLog.BeginCycle();
+    _catalog.Sync();
+    if (!_cfg.enabled)
+        LOG_INFO("mod.dynamicah", "[BUY] Disabled; skipping build");
+}
 
-    // Trade Goods (profession mats) are allowed even if white/gray.
-    if (t->Class == ITEM_CLASS_TRADE_GOODS)
-        return true;
+void BuyEngine::BeginPlan()
+{
+    _beginPlan();
+    _plan.BeginPlan();
+}
 
-    // If configured to block poor/common, then block them unless allow-listed
-    if ((t->Quality <= ITEM_QUALITY_NORMAL) && _cfg.blockTrashAndCommon)
-        return false;
+bool BuyEngine::PlanStep(
+    Core::IAuctionSource &source,
+    std::function<uint32_t(uint32_t, AuctionHouseId)> const &scarceFn,
+    std::function<PricingResult(uint32_t, uint32_t)> const &fairFn,
+    std::function<std::pair<bool, uint32_t>(uint32_t)> const &vendorFn,
+    TickBudget const &budget)
+{
+    FnPolicy policy{scarceFn, fairFn, vendorFn};
+    return PlanStep(source, policy, budget);
+}
 
-    if (t->Quality > 5) // safety
-        return false;
+void BuyEngine::BuildPlanFromRows(
+    std::vector<Core::AuctionFacts> const &rows,
+    std::function<uint32_t(uint32_t, AuctionHouseId)> const &scarceFn,
+    std::function<PricingResult(uint32_t, uint32_t)> const &fairFn,
+    std::function<std::pair<bool, uint32_t>(uint32_t)> const &vendorFn)
+{
+    FnPolicy policy{scarceFn, fairFn, vendorFn};
+    BuildPlanFromRows(rows, policy);
+}
 
-    return _allowQuality[t->Quality];
+void BuyEngine::AdoptPlan(std::vector<BuyCandidate> &&queue, uint64_t budgetUsed)
+{
+    _finishApply();
+    _queue = std::move(queue);
+    _applyNext = 0;
+    Core::BuyLedger &ledger = _plan.Ledger();
+    ledger.Reset();
+    for (BuyCandidate const &c : _queue)
+        ++ledger.perItem[c.itemId];
+    ledger.budgetUsed = budgetUsed;
+    _funds.clear();
+    ++_fundsGen;
+    _fundsPending = false;
+    _plan.Finish();
 }
 
-bool BuyEngine::_passesVendorSafety(uint32_t /*itemId*/, uint32_t unitBuyout, uint32_t vendorBuy) const
+void BuyEngine::_finishPlan()
 {
-    if (!_cfg.neverAboveVendorBuyPrice)
-        return true;
-    if (!_cfg.vendorConsiderBuyPrice)
-        return true;
+    Core::BuyPlanner::Counts const &n = _plan.Stats();
+    LOG_INFO("mod.dynamicah", "[BUY] scanned={} considered={} accepted={} skipped={} items={} queue={} budget={}/{} | {}",
+             n.scanned, n.considered, n.accepted, n.skipped, _plan.Items(),
+             _queue.size(),
+             static_cast<unsigned long long>(_plan.Ledger().budgetUsed),
+             static_cast<unsigned long long>(_cfg.budgetCopper),
+             _planLog.Summary());
+}
 
-    // If vendorBuy known and > 0, ensure we never buy above it (per unit)
-    if (vendorBuy > 0 && unitBuyout > vendorBuy)
-        return false;
+void BuyEngine::_finishApply()
+{
+    if (!_applyTouched)
+        return;
+    LOG_INFO("mod.dynamicah", "[BUY] applied: {}", _applyLog.Summary());
+    _applyLog.BeginCycle();
+    _applyTouched = false;
+}
 
-    return true;
+void BuyEngine::_trace(Core::AuctionFacts const &row, BuyReason reason, uint32_t fairUnit, float margin) const
+{
+    FlightRecorder::Record(TraceStage::BuyPlan, uint8(reason), FromCore(row.house), row.itemId, row.id,
+                           row.count ? row.buyout / row.count : row.buyout, fairUnit, margin);
 }
 
-// -------------------------------------------------------------------------------------------------
-// Planning (scan in-memory auctions; no SQL)
-// -------------------------------------------------------------------------------------------------
+void BuyEngine::Buy(Core::BuyDecision const &d)
+{
+    BuyCandidate bc;
+    bc.auctionId = d.auctionId;
+    bc.houseId = FromCore(d.house);
+    bc.itemId = d.itemId;
+    bc.count = d.count;
+    bc.buyout = d.buyout;
+    bc.startBid = d.startBid;
+    bc.vendorBuy = d.vendorBuy;
+    bc.margin = d.margin;
+    _queue.emplace_back(bc);
+}
 
-void BuyEngine::BuildPlan(
-    std::function<uint32_t(uint32_t, AuctionHouseId)> scarceFn,
-    std::function<PricingResult(uint32_t, uint32_t)> fairFn,
-    std::function<std::pair<bool, uint32_t>(uint32_t)> vendorFn)
+void BuyEngine::Decided(Core::AuctionFacts const &row, Core::ItemFacts const *item, Core::BuyVerdict const &v,
+                        uint32_t vendorBuy, uint64_t usedBefore)
 {
-    if (!_cfg.enabled)
+    uint32_t auctionId = row.id;
+    uint32_t itemId = row.itemId;
+    uint32_t count = row.count;
+    uint32_t buyout = row.buyout; // total stack buyout
+    uint32_t fairUnit = v.fairUnit;
+    uint32_t unitBuyout = v.unitBuyout;
+    float margin = v.margin;
+
+    _trace(row, v.reason, fairUnit, margin);
+    if (!item)
     {
-        LOG_INFO("mod.dynamicah", "[BUY] Disabled; skipping build");
+        // row filters and unknown items
+        DAH_DECISION(_planLog, v.reason, _planEcho, "SKIP", "auc={} item={} reason={}",
+                     auctionId, itemId, BuyReasonNames[size_t(v.reason)]);
         return;
     }
 
-    uint32_t scanned = 0, considered = 0, accepted = 0, skipped = 0;
-    uint32_t scanLimit = _cfg.maxScanRows ? _cfg.maxScanRows : 1000;
-
-    auto scanHouse = [&](AuctionHouseId houseId)
+    ItemTemplate const *tmpl = _catalog.Template(itemId);
+    const char *itemName = tmpl ? tmpl->Name1.c_str() : "";
+    switch (v.reason)
     {
-        AuctionHouseObject *ahObj = sAuctionMgr->GetAuctionsMapByHouseId(houseId);
-        if (!ahObj)
-            return;
+    case BuyReason::Accepted:
+        break;
+    case BuyReason::Quality:
+        DAH_DECISION(_planLog, BuyReason::Quality, _planEcho, "SKIP",
+                  "auc={} item={} '{}' quality={} filtered",
+                  auctionId, itemId, itemName, uint32_t(item->quality));
+        return;
+    case BuyReason::VendorSafety:
+        DAH_DECISION(_planLog, BuyReason::VendorSafety, _planEcho, "SKIP",
+                  "auc={} item={} '{}' reason=vendor-safety unitBuyout={} ({}) vendorBuy={} ({})",
+                  auctionId, itemId, itemName,
+                  unitBuyout, MoneyShort(unitBuyout),
+                  vendorBuy, MoneyShort(vendorBuy));
+        return;
+    case BuyReason::Margin:
+        DAH_DECISION(_planLog, BuyReason::Margin, _planEcho, "SKIP",
+                  "auc={} item={} '{}' reason=margin-too-small margin={:.1f}% need>={:.1f}% buyout={} ({}) fairStack={} ({})",
+                  auctionId, itemId, itemName,
+                  margin * 100.0f, _cfg.minMargin * 100.0f,
+                  buyout, MoneyShort(buyout),
+                  v.fairStack, MoneyShort(v.fairStack));
+        return;
+    case BuyReason::PerItemCap:
+        DAH_DECISION(_planLog, BuyReason::PerItemCap, _planEcho, "SKIP",
+                  "auc={} item={} '{}' reason=per-item-cap cap={}",
+                  auctionId, itemId, itemName, _cfg.perItemPerCycleCap);
+        return;
+    case BuyReason::Budget:
+        DAH_DECISION(_planLog, BuyReason::Budget, _planEcho, "SKIP",
+                  "auc={} item={} '{}' reason=budget-exceeded buyout={} ({}) used={} ({}) limit={} ({})",
+                  auctionId, itemId, itemName,
+                  buyout, MoneyShort(buyout),
+                  usedBefore, MoneyShort(uint32(usedBefore)),
+                  _cfg.budgetCopper, MoneyShort(uint32(_cfg.budgetCopper)));
+        return;
+    default:
+        DAH_DECISION(_planLog, v.reason, _planEcho, "SKIP", "auc={} item={} reason={}",
+                  auctionId, itemId, BuyReasonNames[size_t(v.reason)]);
+        return;
+    }
 
-        auto const &map = ahObj->GetAuctions();
-        for (auto const &kv : map)
-        {
-            if (scanned >= scanLimit)
-                break;
+    // Accept (queued by Buy)
+    DAH_DECISION(_planLog, BuyReason::Accepted, _planEcho, "ACCEPT",
+              "auc={} item={} '{}' x{} unitBuyout={} ({}) fairUnit={} ({}) margin={:.1f}% house={}",
+              auctionId, itemId, itemName, count,
+              unitBuyout, MoneyShort(unitBuyout),
+              fairUnit, MoneyShort(fairUnit),
+              margin * 100.0f, static_cast<uint32_t>(row.house));
+    LogBuyDecision("enqueue", auctionId, itemId, count, unitBuyout, fairUnit,
+                   (fairUnit ? (double(fairUnit) - double(unitBuyout)) * 100.0 / double(fairUnit) : 0.0),
+                   uint32(_plan.Ledger().budgetUsed), "ok");
+}
 
-            AuctionEntry const *A = kv.second;
-            if (!A)
-                continue;
+// -------------------------------------------------------------------------------------------------
+// Apply
+// -------------------------------------------------------------------------------------------------
 
-            ++scanned;
+uint32_t BuyEngine::_botFor(AuctionHouseId house) const
+{
+    switch (house)
+    {
+    case AuctionHouseId::Alliance:
+        return _cfg.ownerAlliance;
+    case AuctionHouseId::Horde:
+        return _cfg.ownerHorde;
+    default:
+        return _cfg.ownerNeutral;
+    }
+}
 
-            uint32_t auctionId = A->Id;
-            uint32_t itemId = A->item_template; // set on post; present in AuctionEntry
-            uint32_t count = A->itemCount ? A->itemCount : 1u;
-            uint32_t buyout = A->buyout;     // total stack buyout
-            uint32_t startBid = A->startbid; // total stack startBid
+void BuyEngine::RequestFunds(QueryCallbackProcessor &proc)
+{
+    std::string guids;
+    for (uint32_t low : {_cfg.ownerAlliance, _cfg.ownerHorde, _cfg.ownerNeutral})
+        if (low)
+            guids += fmt::format("{}{}", guids.empty() ? "" : ",", low);
+    if (guids.empty())
+        return; // no buyer: every buyout stops at NoBuyer
+
+    // One read per plan; the buyouts of this plan are debited locally, so the balances do not
+    // depend on when the earlier apply transactions commit.
+    _fundsPending = true;
+    uint32_t gen = _fundsGen;
+    proc.AddCallback(CharacterDatabase.AsyncQuery(fmt::format("SELECT guid, money FROM characters WHERE guid IN ({})", guids))
+                         .WithCallback([this, gen](QueryResult r)
+    {
+        if (gen != _fundsGen)
+            return; // a newer plan replaced the one this was loaded for
 
-            if (!buyout)
+        if (r)
+        {
+            do
             {
-                ++skipped;
-                _traceWhy(_planEcho, "SKIP", "auc={} item={} reason=no-buyout", auctionId, itemId);
-                continue;
-            }
+                Field *f = r->Fetch();
+                _funds[f[0].Get<uint32>()] = f[1].Get<uint32>();
+            } while (r->NextRow());
+        }
+        _fundsPending = false;
+        LOG_DEBUG("mod.dynamicah", "[BUY] loaded {} bot balance(s)", _funds.size());
+    }));
+}
 
-            ItemTemplate const *tmpl = sObjectMgr->GetItemTemplate(itemId);
-            const char *itemName = tmpl ? tmpl->Name1.c_str() : "unknown";
+uint64_t BuyEngine::_offlineFunds(uint32_t guidLow) const
+{
+    auto it = _funds.find(guidLow);
+    return it != _funds.end() ? it->second : 0; // no characters row: nothing to pay with
+}
 
-            if (!tmpl)
-            {
-                ++skipped;
-                _traceWhy(_planEcho, "SKIP", "auc={} item={} reason=no-template", auctionId, itemId);
-                continue;
-            }
+bool BuyEngine::_executeBuyout(BuyCandidate const &c, CharacterDatabaseTransaction trans, ChatHandler *handler)
+{
+    // The plan may be minutes old: the auction must still be there, unchanged and unbid.
+    AuctionHouseObject *ahObj = sAuctionMgr->GetAuctionsMapByHouseId(c.houseId);
+    AuctionEntry *A = ahObj ? ahObj->GetAuction(c.auctionId) : nullptr;
+    ApplyReason why = ApplyReason::Bought;
+    if (!A)
+        why = ApplyReason::Gone;
+    else if (A->buyout != c.buyout || A->item_template != c.itemId || A->itemCount != c.count)
+        why = ApplyReason::Changed;
+    else if (!A->bidder.IsEmpty())
+        why = ApplyReason::HasBid;
+    else if (_cfg.IsBot(A->owner.GetCounter()))
+        why = ApplyReason::OwnAuction;
+
+    uint32_t buyerLow = _botFor(c.houseId);
+    if (why == ApplyReason::Bought && !buyerLow)
+        why = ApplyReason::NoBuyer;
+
+    // The bot pays the full buyout or does not buy: the seller's mail carries the whole amount.
+    // An online bot's money lives on the Player (its next save would overwrite a DB update).
+    Player *buyer = why == ApplyReason::Bought ? ObjectAccessor::FindPlayerByLowGUID(buyerLow) : nullptr;
+    if (why == ApplyReason::Bought && (buyer ? uint64_t(buyer->GetMoney()) : _offlineFunds(buyerLow)) < c.buyout)
+        why = ApplyReason::NoFunds;
+
+    uint32_t unitPaid = c.count ? c.buyout / c.count : c.buyout;
+    FlightRecorder::Record(TraceStage::BuyApply, uint8(why), c.houseId, c.itemId, c.auctionId, unitPaid, 0, c.margin);
+    if (why != ApplyReason::Bought)
+    {
+        DAH_DECISION(_applyLog, why, handler, "STALE", "auc={} item={} reason={}", c.auctionId, c.itemId, ApplyReasonNames[size_t(why)]);
+        return false;
+    }
 
-            // Quality filter
-            if (!_qualityAllowed(itemId))
-            {
-                ++skipped;
-                _traceWhy(_planEcho, "SKIP",
-                          "auc={} item={} '{}' quality={} filtered",
-                          auctionId, itemId, itemName, uint32_t(tmpl->Quality));
-                continue;
-            }
-
-            ++considered;
-
-            // Scarcity for fair price calculation
-            uint32_t activeCount = scarceFn ? scarceFn(itemId, houseId) : 0;
-            PricingResult fair = fairFn ? fairFn(itemId, activeCount) : PricingResult{0, 0};
-
-            // Compute "fair value" for this stack (prefer buyout guidance per unit if available)
-            uint32_t fairUnit = fair.buyout ? fair.buyout : std::max<uint32_t>(_cfg.minPriceCopper, tmpl->SellPrice * 2);
-            uint32_t fairStack = fairUnit * count;
-
-            // Vendor safety
-            uint32_t vendorBuy = 0;
-            if (vendorFn)
-            {
-                auto v = vendorFn(itemId);
-                vendorBuy = v.second;
-            }
-            uint32_t unitBuyout = (count ? (buyout / count) : buyout);
-            if (!_passesVendorSafety(itemId, unitBuyout, vendorBuy))
-            {
-                ++skipped;
-                _traceWhy(_planEcho, "SKIP",
-                          "auc={} item={} '{}' reason=vendor-safety unitBuyout={} ({}) vendorBuy={} ({})",
-                          auctionId, itemId, itemName,
-                          unitBuyout, MoneyShort(unitBuyout),
-                          vendorBuy, MoneyShort(vendorBuy));
-                continue;
-            }
-
-            // Margin check (how much cheaper vs fair)
-            float margin = 0.0f;
-            if (fairStack > 0 && buyout < fairStack)
-                margin = float(fairStack - buyout) / float(fairStack);
-
-            if (margin < _cfg.minMargin)
-            {
-                ++skipped;
-                _traceWhy(_planEcho, "SKIP",
-                          "auc={} item={} '{}' reason=margin-too-small margin={:.1f}% need>={:.1f}% buyout={} ({}) fairStack={} ({})",
-                          auctionId, itemId, itemName,
-                          margin * 100.0f, _cfg.minMargin * 100.0f,
-                          buyout, MoneyShort(buyout),
-                          fairStack, MoneyShort(fairStack));
-                continue;
-            }
-
-            // Per-item per-cycle cap
-            uint32_t &plannedForItem = _perItemCount[itemId];
-            if (plannedForItem >= _cfg.perItemPerCycleCap)
-            {
-                ++skipped;
-                _traceWhy(_planEcho, "SKIP",
-                          "auc={} item={} '{}' reason=per-item-cap cap={}",
-                          auctionId, itemId, itemName, _cfg.perItemPerCycleCap);
-                continue;
-            }
-
-            // Budget check
-            if (_budgetUsed + buyout > _cfg.budgetCopper)
-            {
-                ++skipped;
-                _traceWhy(_planEcho, "SKIP",
-                          "auc={} item={} '{}' reason=budget-exceeded buyout={} ({}) used={} ({}) limit={} ({})",
-                          auctionId, itemId, itemName,
-                          buyout, MoneyShort(buyout),
-                          _budgetUsed, MoneyShort(uint32(_budgetUsed)),
-                          _cfg.budgetCopper, MoneyShort(uint32(_cfg.budgetCopper)));
-                continue;
-            }
-
-            // Accept
-            BuyCandidate bc;
-            bc.auctionId = auctionId;
-            bc.houseId = houseId;
-            bc.itemId = itemId;
-            bc.count = count;
-            bc.buyout = buyout;
-            bc.startBid = startBid;
-            bc.vendorBuy = vendorBuy;
-            bc.margin = margin;
-
-            _queue.emplace_back(bc);
-            ++plannedForItem;
-            _budgetUsed += buyout;
-            ++accepted;
-
-            _traceWhy(_planEcho, "ACCEPT",
-                      "auc={} item={} '{}' x{} unitBuyout={} ({}) fairUnit={} ({}) margin={:.1f}% house={}",
-                      auctionId, itemId, itemName, count,
-                      unitBuyout, MoneyShort(unitBuyout),
-                      fairUnit, MoneyShort(fairUnit),
-                      margin * 100.0f, static_cast<uint32_t>(houseId));
-            LogBuyDecision("enqueue", auctionId, itemId, count, unitBuyout, fairUnit,
-                           (fairUnit ? (double(fairUnit) - double(unitBuyout)) * 100.0 / double(fairUnit) : 0.0),
-                           uint32(_budgetUsed), "ok");
-
-
-            if (scanned >= scanLimit)
-                break;
-        }
-    };
+    // Same sequence as a player buyout (WorldSession::HandleAuctionPlaceBid)
+    A->bidder = ObjectGuid::Create<HighGuid::Player>(buyerLow);
+    A->bid = A->buyout;
 
-    // Scan houses until we hit scanLimit
-    scanHouse(AuctionHouseId::Alliance);
-    if (scanned < scanLimit)
-        scanHouse(AuctionHouseId::Horde);
-    if (scanned < scanLimit)
-        scanHouse(AuctionHouseId::Neutral);
+    sAuctionMgr->SendAuctionSalePendingMail(A, trans);
+    sAuctionMgr->SendAuctionSuccessfulMail(A, trans);
+    sAuctionMgr->SendAuctionWonMail(A, trans);
+    sScriptMgr->OnAuctionSuccessful(ahObj, A);
 
-    LOG_INFO("mod.dynamicah", "[BUY] scanned={} considered={} accepted={} skipped={} queue={} budget={}/{}",
-             scanned, considered, accepted, skipped,
-             _queue.size(),
-             static_cast<unsigned long long>(_budgetUsed),
-             static_cast<unsigned long long>(_cfg.budgetCopper));
-}
+    // Pay before the entry is deleted; funds were checked above, so nothing is clamped
+    if (buyer)
+    {
+        buyer->ModifyMoney(-int32(c.buyout));
+        buyer->SaveInventoryAndGoldToDB(trans);
+        _funds[buyerLow] = buyer->GetMoney(); // what the DB holds if it logs out during the plan
+    }
+    else
+    {
+        trans->Append("UPDATE characters SET money = money - {0} WHERE guid = {1} AND money >= {0}",
+                      c.buyout, buyerLow);
+        _funds[buyerLow] -= c.buyout;
+    }
 
-// -------------------------------------------------------------------------------------------------
-// Apply
-// -------------------------------------------------------------------------------------------------
+    A->DeleteFromDB(trans);
+    sAuctionMgr->RemoveAItem(A->item_guid);
+    ahObj->RemoveAuction(A); // deletes A
+
+    DAH_DECISION(_applyLog, ApplyReason::Bought, handler, "BOUGHT", "auc={} item={} x{} unitPaid={}c",
+                 c.auctionId, c.itemId, c.count, unitPaid);
+    return true;
+}
 
 uint32_t BuyEngine::Apply(uint32_t maxToApply, bool dryRun, ChatHandler *handler)
 {
     if (!_cfg.enabled)
         return 0;
 
-    _chatLinesThisApply = 0;
-
-    uint32_t applied = 0;
-    for (BuyCandidate const &c : _queue)
+    size_t end = std::min(_queue.size(), _applyNext + maxToApply);
+    if (_applyNext >= end)
+        return 0;
+    if (!dryRun && _fundsPending)
     {
-        if (applied >= maxToApply)
-            break;
+        if (handler)
+            handler->PSendSysMessage("ModDynamicAH[BUY]: bot balances are still loading; try again.");
+        return 0; // the funds check needs the balances; the next tick picks up the batch
+    }
+    _applyTouched = true;
 
-        if (dryRun)
+    uint32_t processed = 0, bought = 0;
+    if (dryRun)
+    {
+        for (; _applyNext < end; ++_applyNext, ++processed)
         {
-            _traceWhy(handler, "DRY", "auc={} item={} x{} buyout={} margin={:.1f}% house={} vendorBuy={}",
-                      c.auctionId, c.itemId, c.count, c.buyout, c.margin * 100.0f,
-                      static_cast<uint32_t>(c.houseId), c.vendorBuy);
-            LogBuyResult(c.auctionId, c.itemId, c.count, (c.count ? c.buyout / c.count : c.buyout), "ok-dry");
-
+            BuyCandidate const &c = _queue[_applyNext];
+            FlightRecorder::Record(TraceStage::BuyApply, uint8(ApplyReason::DryRun), c.houseId, c.itemId, c.auctionId,
+                                   c.count ? c.buyout / c.count : c.buyout, 0, c.margin);
+            DAH_DECISION(_applyLog, ApplyReason::DryRun, handler, "DRY",
+                         "auc={} item={} x{} buyout={} margin={:.1f}% house={} vendorBuy={}",
+                         c.auctionId, c.itemId, c.count, c.buyout, c.margin * 100.0f,
+                         static_cast<uint32_t>(c.houseId), c.vendorBuy);
         }
-        else
+    }
+    else
+    {
+        CharacterDatabaseTransaction trans = CharacterDatabase.BeginTransaction();
+        for (; _applyNext < end; ++_applyNext, ++processed)
         {
-            // TODO: implement actual buyout logic with mail handling & gold management.
-            _traceWhy(handler, "LIVE-NYI", "would buy auc={} item={} x{} buyout={} margin={:.1f}%",
-                      c.auctionId, c.itemId, c.count, c.buyout, c.margin * 100.0f);
-            LogBuyResult(c.auctionId, c.itemId, c.count, 0, "live-nyi");
-
+            if (_executeBuyout(_queue[_applyNext], trans, handler))
+                ++bought;
         }
+        CharacterDatabase.CommitTransaction(trans);
+
+        if (handler)
+            handler->PSendSysMessage("ModDynamicAH[BUY]: bought {}/{} in a single DB commit.", bought, processed);
+    }
 
-        ++applied;
+    // fully consumed: release the plan
+    if (_applyNext >= _queue.size())
+    {
+        _queue.clear();
+        _applyNext = 0;
+        _finishApply();
     }
 
-    return applied;
+    return processed;
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -316,18 +421,18 @@ void BuyEngine::CmdShow(ChatHandler *handler) const
         handler->PSendSysMessage(
             "ModDynamicAH[BUY]: enabled={} budget={}/{} cap/item={} minMargin={:.1f}% scanLimit={} debug={} queue={}",
             _cfg.enabled ? "1" : "0",
-            static_cast<unsigned long long>(_budgetUsed),
+            static_cast<unsigned long long>(_plan.Ledger().budgetUsed),
             static_cast<unsigned long long>(_cfg.budgetCopper),
             _cfg.perItemPerCycleCap,
             _cfg.minMargin * 100.0f,
             _cfg.maxScanRows,
-            _debug ? "1" : "0",
+            _cfg.debug ? "1" : "0",
             _queue.size());
     }
     LOG_INFO("mod.dynamicah",
              "[BUY] enabled={} budget={}/{} cap/item={} minMargin={:.1f}% scanLimit={} debug={} queue={}",
-             _cfg.enabled, _budgetUsed, _cfg.budgetCopper, _cfg.perItemPerCycleCap,
-             _cfg.minMargin * 100.0f, _cfg.maxScanRows, _debug, _queue.size());
+             _cfg.enabled, _plan.Ledger().budgetUsed, _cfg.budgetCopper, _cfg.perItemPerCycleCap,
+             _cfg.minMargin * 100.0f, _cfg.maxScanRows, _cfg.debug, _queue.size());
 }
 
 void BuyEngine::CmdEnable(ChatHandler *handler, bool enable)
@@ -358,14 +463,14 @@ void BuyEngine::CmdPerItem(ChatHandler *handler, uint32_t cap)
         handler->PSendSysMessage("ModDynamicAH[BUY]: per-item/cycle cap set to {}", _cfg.perItemPerCycleCap);
 }
 
-void BuyEngine::CmdOnce(ChatHandler *handler,
+void BuyEngine::CmdOnce(ChatHandler *handler, Core::IAuctionSource &source,
                         std::function<uint32_t(uint32_t, AuctionHouseId)> scarceFn,
                         std::function<PricingResult(uint32_t, uint32_t)> fairFn,
                         std::function<std::pair<bool, uint32_t>(uint32_t)> vendorFn)
 {
     ResetCycle();
     _planEcho = handler; // echo reasons for this one run
-    BuildPlan(scarceFn, fairFn, vendorFn);
+    BuildPlan(source, scarceFn, fairFn, vendorFn);
     _planEcho = nullptr;
 
     uint32_t did = Apply(50, /*dryRun=*/true, handler);
@@ -375,19 +480,18 @@ void BuyEngine::CmdOnce(ChatHandler *handler,
 
 void BuyEngine::CmdDebug(ChatHandler *handler, bool on)
 {
-    _debug = on;
+    SetDebug(on);
     if (handler)
         handler->PSendSysMessage("ModDynamicAH[BUY]: debug {}", on ? "enabled" : "disabled");
 }
 
-
 void BuyEngine::LogBuyDecision(char const* phase, uint32_t aucId, uint32_t itemId, uint32_t count,
                                uint32_t unitAskCopper, uint32_t fairUnitCopper, double marginPct,
                                uint32_t budgetRemainCopper, char const* reason) const
 {
-    if (!_debug) return;
-    ItemTemplate const* t = sObjectMgr->GetItemTemplate(itemId);
-    LOG_INFO("mod_dynamic_ah",
+    if (!_cfg.debug || !sLog->ShouldLog("mod_dynamic_ah", LOG_LEVEL_DEBUG)) return;
+    ItemTemplate const* t = _catalog.Template(itemId);
+    LOG_DEBUG("mod_dynamic_ah",
              "buy {}: auc={} item={} '{}' x{} ask={}c fair={}c margin={:.1f}% budgetRemain={}c reason={}",
              phase, aucId, itemId, (t ? t->Name1 : std::string("")), count,
              unitAskCopper, fairUnitCopper, marginPct, budgetRemainCopper, (reason ? reason : ""));
@@ -396,9 +500,9 @@ void BuyEngine::LogBuyDecision(char const* phase, uint32_t aucId, uint32_t itemI
 void BuyEngine::LogBuyResult(uint32_t aucId, uint32_t itemId, uint32_t count,
                              uint32_t unitPaidCopper, char const* result) const
 {
-    if (!_debug) return;
-    ItemTemplate const* t = sObjectMgr->GetItemTemplate(itemId);
-    LOG_INFO("mod_dynamic_ah",
+    if (!_cfg.debug || !sLog->ShouldLog("mod_dynamic_ah", LOG_LEVEL_DEBUG)) return;
+    ItemTemplate const* t = _catalog.Template(itemId);
+    LOG_DEBUG("mod_dynamic_ah",
              "buy result: auc={} item={} '{}' x{} unitPaid={}c result={}",
              aucId, itemId, (t ? t->Name1 : std::string("")), count, unitPaidCopper, (result ? result : ""));
 }
@@ -6,67 +6,176 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <functional>
+#include <array>
+#include <type_traits>
 
 #include <fmt/format.h>       // fmt::format
 #include "Chat.h"             // ChatHandler
+#include "QueryCallbackProcessor.h"
 #include "Log.h"              // LOG_INFO
 #include "AuctionHouseMgr.h"  // AuctionHouseId (core type, no redeclare!)
 #include "DynamicAHTypes.h"   // shared enums/aliases for the module
-#include "DynamicAHPricing.h" // PricingResult
+#include "DynamicAHCycle.h"   // TickBudget
+#include "DynamicAHDecisionLog.h"
+#include "DynamicAHCoreAdapters.h" // IndexItemCatalog, LiveAuctionSource, FromCore
+#include "CoreBuyPlanner.h"        // Core::BuyPlanner, DefaultBuyPolicy
 
 namespace ModDynamicAH
 {
     //--------------------------------------------------------------------------------------------------
     // Configuration for the buy engine
     //--------------------------------------------------------------------------------------------------
-    struct BuyEngineConfig
+    // Decision settings (budget, margin, caps, vendor safety, bot owners) are Core::BuyRules; the
+    // scan switch and row limit are Core::BuyScanRules
+    struct BuyEngineConfig : Core::BuyScanRules
     {
-        bool enabled = false;
-        uint64_t budgetCopper = 0;       // per-cycle budget in copper
-        float minMargin = 0.15f;         // required discount vs fair buyout (0.15 = 15%)
-        uint32_t perItemPerCycleCap = 2; // cap accepted per item per plan cycle
-        uint32_t maxScanRows = 2000;
-        bool blockTrashAndCommon = true; // block q=poor/common unless allow-listed
-
-        // Vendor safety
-        bool vendorConsiderBuyPrice = true;   // treat BuyPrice>0 as vendor-sold
-        bool neverAboveVendorBuyPrice = true; // do not buy if unit buyout > vendor BuyPrice
-        uint32_t minPriceCopper = 10000;      // fallback min when vendor info missing
-
         // Context (for pricing)
         bool scarcityEnabled = true;
         uint32_t onlineCount = 0;
+
+        // Logging: one summary per plan (and per consumed plan); per-row lines only with debug
+        bool debug = false;
+        uint32_t logDetailPerCycle = 50;
     };
 
+    using Core::BuyReason;
+    using Core::BuyReasonNames;
+    using Core::DefaultBuyPolicy; // scan policy contract: see CoreBuyPlanner.h
+    using Core::PricingResult;
+
+    enum class ApplyReason : uint8_t
+    {
+        Bought,
+        DryRun,
+        Gone,
+        Changed,
+        HasBid,
+        OwnAuction,
+        NoBuyer,
+        NoFunds,
+        COUNT
+    };
+
+    inline constexpr std::array<char const *, size_t(ApplyReason::COUNT)> ApplyReasonNames = {
+        "bought", "dry-run", "gone", "changed", "has-bid", "own-auction", "no-buyer", "no-funds"};
+
     //--------------------------------------------------------------------------------------------------
-    // Buy engine: scans AH rows, filters, plans buys, and (for now) traces decisions
+    // Buy engine: plans buys with Core::BuyPlanner over the item index, traces and logs its
+    // decisions, and applies the plan against the live auction houses
     //--------------------------------------------------------------------------------------------------
-    class BuyEngine
+    class BuyEngine final : private Core::IPersistenceSink, private Core::IBuyObserver
     {
     public:
-        BuyEngine() = default;
+        struct BuyCandidate
+        {
+            uint32_t auctionId;
+            AuctionHouseId houseId;
+            uint32_t itemId;
+            uint32_t count;     // stack count
+            uint32_t buyout;    // total stack buyout (copper)
+            uint32_t startBid;  // total stack start bid
+            uint32_t vendorBuy; // vendor BuyPrice (unit), 0 if not vendor
+            float margin;       // discount vs fair (0.15 = 15%)
+        };
+
+        BuyEngine() : _plan(_cfg, _catalog, *this) { _plan.SetObserver(this); }
+        BuyEngine(BuyEngine const &) = delete;
+        BuyEngine &operator=(BuyEngine const &) = delete;
 
         // Config / filters
-        void SetConfig(BuyEngineConfig const &cfg) { _cfg = cfg; }
+        void SetConfig(BuyEngineConfig const &cfg)
+        {
+            _cfg = cfg;
+            SetDebug(cfg.debug);
+            _planLog.SetDetailLimit(cfg.logDetailPerCycle);
+            _applyLog.SetDetailLimit(cfg.logDetailPerCycle);
+        }
+        BuyEngineConfig const &Config() const { return _cfg; }
         void SetFilters(bool allowQuality[6], std::unordered_set<uint32_t> const &whiteAllow);
-        void SetDebug(bool on) { _debug = on; } // echo reasons to chat/log
+        void SetDebug(bool on) // per-row decision lines (rate limited)
+        {
+            _cfg.debug = on;
+            _planLog.SetDebug(on);
+            _applyLog.SetDebug(on);
+        }
 
-        // Planning (lambdas provided by caller)
+        // Planning over an auction source (LiveAuctionSource on the world thread). Policies are
+        // Core::BuyPlanner scan policies; the std::function overloads adapt caller lambdas:
         //  - scarceFn:  (itemId, houseId) -> active count of item in that AH
         //  - fairFn:    (itemId, activeCount) -> PricingResult (unit guidance)
         //  - vendorFn:  (itemId) -> { isVendor, vendorBuyPrice }
         void ResetCycle();
+        template <typename Policy>
+        void BuildPlan(Core::IAuctionSource &source, Policy &policy)
+        {
+            BeginPlan();
+            PlanStep(source, policy, TickBudget::Unlimited());
+        }
         void BuildPlan(
+            Core::IAuctionSource &source,
             std::function<uint32_t(uint32_t, AuctionHouseId)> scarceFn,
             std::function<PricingResult(uint32_t, uint32_t)> fairFn,
             std::function<std::pair<bool, uint32_t>(uint32_t)> vendorFn);
 
-        // Apply up to N planned buys. If dryRun=true, only logs. Returns number “applied”.
+        // Resumable planning: BeginPlan() rewinds the scan cursor, PlanStep() scans until the
+        // budget runs out and returns true once every house was scanned (or the row limit hit).
+        void BeginPlan();
+        template <typename Policy>
+        bool PlanStep(Core::IAuctionSource &source, Policy &policy, TickBudget const &budget)
+        {
+            if (_plan.Done())
+                return true;
+            if (!_plan.PlanStep(source, policy, budget))
+                return false;
+            _finishPlan();
+            return true;
+        }
+        // std::function adapter
+        bool PlanStep(
+            Core::IAuctionSource &source,
+            std::function<uint32_t(uint32_t, AuctionHouseId)> const &scarceFn,
+            std::function<PricingResult(uint32_t, uint32_t)> const &fairFn,
+            std::function<std::pair<bool, uint32_t>(uint32_t)> const &vendorFn,
+            TickBudget const &budget);
+
+        // Snapshot planning: scans pre-copied rows (scan order A, H, N) instead of the live
+        // auction maps, so it can run off the world thread.
+        template <typename Policy>
+        void BuildPlanFromRows(std::vector<Core::AuctionFacts> const &rows, Policy &policy)
+        {
+            _beginPlan();
+            _plan.BuildPlanFromRows(rows, policy);
+            if (_cfg.enabled)
+                _finishPlan();
+        }
+        // std::function adapter
+        void BuildPlanFromRows(
+            std::vector<Core::AuctionFacts> const &rows,
+            std::function<uint32_t(uint32_t, AuctionHouseId)> const &scarceFn,
+            std::function<PricingResult(uint32_t, uint32_t)> const &fairFn,
+            std::function<std::pair<bool, uint32_t>(uint32_t)> const &vendorFn);
+
+        // Plan handoff between engines (worker -> world)
+        std::vector<BuyCandidate> TakePlan()
+        {
+            std::vector<BuyCandidate> out = std::move(_queue);
+            _queue.clear();
+            _applyNext = 0;
+            return out;
+        }
+        void AdoptPlan(std::vector<BuyCandidate> &&queue, uint64_t budgetUsed);
+
+        // Loads the bot balances for the current plan in one async query; call once per plan
+        // (after BeginPlan or AdoptPlan). Live Apply waits until the result is in.
+        void RequestFunds(QueryCallbackProcessor &proc);
+
+        // Consume up to N planned buys from the cursor. Live mode re-validates each auction and
+        // settles the whole batch in one CharacterDatabaseTransaction. Returns the number processed.
         uint32_t Apply(uint32_t maxToApply, bool dryRun, ChatHandler *handler);
 
         // Introspection / commands
-        size_t QueueSize() const { return _queue.size(); }
-        uint64_t BudgetUsed() const { return _budgetUsed; }
+        size_t QueueSize() const { return _queue.size() - _applyNext; }
+        uint64_t BudgetUsed() const { return _plan.Ledger().budgetUsed; }
         uint64_t BudgetLimit() const { return _cfg.budgetCopper; }
 
         void CmdShow(ChatHandler *handler) const;
@@ -74,7 +183,7 @@ namespace ModDynamicAH
         void CmdBudget(ChatHandler *handler, uint32_t gold);
         void CmdMargin(ChatHandler *handler, uint32_t percent);
         void CmdPerItem(ChatHandler *handler, uint32_t cap);
-        void CmdOnce(ChatHandler *handler,
+        void CmdOnce(ChatHandler *handler, Core::IAuctionSource &source,
                      std::function<uint32_t(uint32_t, AuctionHouseId)> scarceFn,
                      std::function<PricingResult(uint32_t, uint32_t)> fairFn,
                      std::function<std::pair<bool, uint32_t>(uint32_t)> vendorFn);
@@ -90,62 +199,60 @@ namespace ModDynamicAH
                           uint32_t unitPaidCopper, char const* result) const;
 
     private:
-        struct BuyCandidate
-        {
-            uint32_t auctionId;
-            AuctionHouseId houseId;
-            uint32_t itemId;
-            uint32_t count;     // stack count
-            uint32_t buyout;    // total stack buyout (copper)
-            uint32_t startBid;  // total stack start bid
-            uint32_t vendorBuy; // vendor BuyPrice (unit), 0 if not vendor
-            float margin;       // discount vs fair (0.15 = 15%)
-        };
+        // Core::IPersistenceSink: accepted buys go to the plan queue (the buy planner never posts)
+        void Post(Core::PostDecision const & /*d*/) override {}
+        void Buy(Core::BuyDecision const &d) override;
+        // Core::IBuyObserver: flight recorder + BUY decision log
+        void Decided(Core::AuctionFacts const &row, Core::ItemFacts const *item, Core::BuyVerdict const &v,
+                     uint32_t vendorBuy, uint64_t budgetBefore) override;
 
         // Internal helpers
-        bool _qualityAllowed(uint32_t itemId) const;
-        bool _passesVendorSafety(uint32_t itemId, uint32_t unitBuyout, uint32_t vendorBuy) const;
+        uint32_t _botFor(AuctionHouseId house) const;
+        // Balance of an offline bot: loaded by RequestFunds, then debited by each buyout
+        uint64_t _offlineFunds(uint32_t guidLow) const;
+        // Buys one validated auction into trans; false if it is gone, changed or bid on.
+        bool _executeBuyout(BuyCandidate const &c, CharacterDatabaseTransaction trans, ChatHandler *handler);
+        void _beginPlan(); // per-plan log state + item index snapshot
+        void _finishPlan();
+        void _finishApply();
+        void _trace(Core::AuctionFacts const &row, BuyReason reason, uint32_t fairUnit = 0, float margin = 0.0f) const;
 
-        // Tracer using {fmt}; visible to both .cpp and callers
-        static void _traceWhy(ChatHandler *handler,
-                              std::string_view tag,
-                              std::string_view msg)
+        // Adapts the legacy std::function callbacks (any of which may be empty)
+        struct FnPolicy
         {
-            const std::string s(msg);
-            if (handler)
-                handler->SendSysMessage(("ModDynamicAH[BUY][" + std::string(tag) + "] " + s).c_str());
-            LOG_INFO("mod.dynamicah", "BUY[{}] {}", tag, s);
-        }
+            std::function<uint32_t(uint32_t, AuctionHouseId)> const &scarceFn;
+            std::function<PricingResult(uint32_t, uint32_t)> const &fairFn;
+            std::function<std::pair<bool, uint32_t>(uint32_t)> const &vendorFn;
 
-        template <typename... Args>
-        static void _traceWhy(ChatHandler *handler,
-                              std::string_view tag,
-                              std::string_view fmtStr,
-                              Args &&...args)
-        {
-            const std::string s = fmt::format(fmtStr, std::forward<Args>(args)...);
-            if (handler)
-                handler->SendSysMessage(("ModDynamicAH[BUY][" + std::string(tag) + "] " + s).c_str());
-            LOG_INFO("mod.dynamicah", "BUY[{}] {}", tag, s);
-        }
+            uint32_t Scarcity(uint32_t itemId, Core::House house) const { return scarceFn ? scarceFn(itemId, FromCore(house)) : 0; }
+            PricingResult Fair(Core::ItemFacts const &item, uint32_t active) const
+            {
+                return fairFn ? fairFn(item.itemId, active) : PricingResult{0, 0};
+            }
+            uint32_t VendorBuy(Core::ItemFacts const &item) const { return vendorFn ? vendorFn(item.itemId).second : 0; }
+        };
 
         BuyEngineConfig _cfg;
-
-        bool _allowQuality[6] = {false, false, true, true, true, false};
-        std::unordered_set<uint32_t> _whiteAllow;
+        IndexItemCatalog _catalog; // item index snapshot taken by BeginPlan
 
         // Plan state
         std::vector<BuyCandidate> _queue;
-        std::unordered_map<uint32_t, uint32_t> _perItemCount; // itemId -> planned buys in this cycle
-        uint64_t _budgetUsed = 0;
+        size_t _applyNext = 0; // Apply cursor into _queue
+        std::unordered_map<uint32_t, uint64_t> _funds; // bot guid low -> copper left (see RequestFunds)
+        uint32_t _fundsGen = 0;     // bumped per plan; drops a result that arrives for an older plan
+        bool _fundsPending = false; // RequestFunds issued, result not in yet
 
-        // Debug
-        bool _debug = true; // default on: emits LOG_INFO here, and to Chat if handler != nullptr
-        mutable uint32_t _chatLinesThisApply = 0;
-        static constexpr uint32_t _chatLineCapPerApply = 40;
+        // Decision accounting (see DecisionLog)
+        DecisionLog<BuyReason> _planLog{"BUY", BuyReasonNames};
+        DecisionLog<ApplyReason> _applyLog{"BUY", ApplyReasonNames};
+        bool _applyTouched = false;
 
         // Plan-phase chat echo (only when invoked from .dah buy once)
         ChatHandler *_planEcho = nullptr;
+
+        // Scan, ledger (per-item counts and budget committed this cycle) and memo; after the
+        // members it references
+        Core::BuyPlanner _plan;
     };
 
 } // namespace ModDynamicAH
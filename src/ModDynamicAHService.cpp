@@ -65,9 +65,16 @@ namespace
 #include "GameTime.h"
 #include "Log.h"
 #include "WorldSessionMgr.h"
-#include "ProfessionMats.h"
-#include "DynamicAHPricing.h"
 #include "DynamicAHDifficulty.h"
+#include "DynamicAHIndexCache.h"
+#include "DynamicAHProfessionIndex.h"
+#include "DynamicAHVendor.h"
+#include "DynamicAHItemIndex.h"
+#include "DynamicAHTrace.h"
+#include "DynamicAHCoreAdapters.h"
+
+#include <array>
+#include <chrono>
 
 using namespace ModDynamicAH;
 
@@ -94,6 +101,9 @@ namespace
             c.scarcityEnabled = s.scarcityEnabled;
             c.scarcityPriceBoostMax = s.scarcityPriceBoostMax;
             c.scarcityPerItemPerTickCap = s.scarcityPerItemPerTickCap;
+            c.scarcityFromMemory = s.scarcityFromMemory;
+            c.scarcityCountUnits = s.scarcityCountUnits;
+            c.scarcityVerifyEvery = s.scarcityVerifyEvery;
 
             // vendor
             c.vendorMinMarkup = s.vendorMinMarkup;
@@ -124,6 +134,8 @@ namespace
             c.contextMaxPerBracket = s.contextMaxPerBracket;
             c.contextWeightBoost = s.contextWeightBoost;
             c.contextSkipVendor = s.contextSkipVendor;
+            c.debugLogs = s.debugContextLogs;
+            c.logDetailPerCycle = s.logDetailPerCycle;
 
             // random selection
             c.blockTrashAndCommon = s.blockTrashAndCommon;
@@ -139,6 +151,88 @@ namespace
 
             return c;
         }
+
+        // Only the keys the sellable pool is filtered by; the planner fills the rest per cycle
+        inline Core::SelectionRules ToSelectionCfg(ModuleState const &s)
+        {
+            Core::SelectionRules sel;
+            sel.blockTrashAndCommon = s.blockTrashAndCommon;
+            std::copy(std::begin(s.allowQuality), std::end(s.allowQuality), std::begin(sel.allowQuality));
+            sel.whitelist = s.whiteAllow;
+            return sel;
+        }
+
+        // Config inputs of the caches OnConfigLoad maintains. Captured before and after a
+        // reload so each cache is rebuilt only when one of its own keys changed.
+        struct CacheKeys
+        {
+            std::string indexCacheFile;       // profession index + creature drop levels
+            uint32_t vendorRefreshMin = 0;    // vendor refresh schedule
+            float vendorMinMarkup = 0.0f;     // vendor sold cache
+            bool vendorConsiderBuyPrice = false;
+            bool blockTrashAndCommon = false; // sellable pool
+            std::array<bool, 6> allowQuality{}; // sellable pool + buy filters
+            std::unordered_set<uint32_t> whiteAllow;
+            uint32_t minPriceCopper = 0;      // price cache + cycle in flight
+            uint32_t intervalMin = 0;         // next run
+            bool scarcityFromMemory = false;  // scarcity index source
+            bool scarcityCountUnits = false;
+
+            static CacheKeys Of(ModuleState const &s)
+            {
+                CacheKeys k;
+                k.indexCacheFile = s.indexCacheFile;
+                k.vendorRefreshMin = s.vendorRefreshMin;
+                k.vendorMinMarkup = s.vendorMinMarkup;
+                k.vendorConsiderBuyPrice = s.vendorConsiderBuyPrice;
+                k.blockTrashAndCommon = s.blockTrashAndCommon;
+                std::copy(std::begin(s.allowQuality), std::end(s.allowQuality), k.allowQuality.begin());
+                k.whiteAllow = s.whiteAllow;
+                k.minPriceCopper = s.minPriceCopper;
+                k.intervalMin = s.intervalMin;
+                k.scarcityFromMemory = s.scarcityFromMemory;
+                k.scarcityCountUnits = s.scarcityCountUnits;
+                return k;
+            }
+        };
+
+        // What one OnConfigLoad rebuilt (with timings), left to rebuild lazily, or kept
+        class ReloadReport
+        {
+        public:
+            template <typename Fn>
+            void Run(char const *name, bool needed, Fn &&rebuild)
+            {
+                if (!needed)
+                {
+                    Append(_kept, name);
+                    return;
+                }
+                auto t0 = std::chrono::steady_clock::now();
+                rebuild();
+                auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count();
+                Append(_rebuilt, std::string(name) + "(" + std::to_string(ms) + "ms)");
+            }
+
+            // cache that notices the change itself on next use
+            void Defer(char const *name, bool needed) { Append(needed ? _deferred : _kept, name); }
+
+            void Log(bool reload) const
+            {
+                LOG_INFO("mod.dynamicah", "config {}: rebuilt [{}] deferred [{}] kept [{}]",
+                         reload ? "reload" : "load", _rebuilt, _deferred, _kept);
+            }
+
+        private:
+            static void Append(std::string &list, std::string const &item)
+            {
+                if (!list.empty())
+                    list += ' ';
+                list += item;
+            }
+
+            std::string _rebuilt, _deferred, _kept;
+        };
     } // anonymous namespace
 
 }
@@ -152,6 +246,8 @@ Service &Service::Instance()
 void Service::OnConfigLoad()
 {
     auto &g = state_;
+    bool const reload = configured_;
+    CacheKeys const before = CacheKeys::Of(g);
 
     g.enableSeller = sConfigMgr->GetOption<bool>(CFG_ENABLE_SELLER, true);
     g.dryRun = sConfigMgr->GetOption<bool>(CFG_DRYRUN, true);
@@ -181,10 +277,15 @@ void Service::OnConfigLoad()
     g.scarcityEnabled = sConfigMgr->GetOption<bool>(CFG_SCARCITY_ENABLED, true);
     g.scarcityPriceBoostMax = sConfigMgr->GetOption<float>(CFG_SCARCITY_PRICE_BOOST_MAX, 0.30f);
     g.scarcityPerItemPerTickCap = sConfigMgr->GetOption<uint32_t>(CFG_SCARCITY_PER_TICK_ITEM_CAP, 1);
+    g.scarcityFromMemory = sConfigMgr->GetOption<bool>(CFG_SCARCITY_FROM_MEMORY, true);
+    g.scarcityCountUnits = sConfigMgr->GetOption<bool>(CFG_SCARCITY_COUNT_UNITS, false);
+    g.scarcityVerifyEvery = sConfigMgr->GetOption<uint32_t>(CFG_SCARCITY_VERIFY_EVERY, 12);
 
     g.vendorMinMarkup = sConfigMgr->GetOption<float>(CFG_VENDOR_MIN_MARKUP, 0.25f);
     g.vendorConsiderBuyPrice = sConfigMgr->GetOption<bool>(CFG_VENDOR_CONSIDER_BUYPRICE, true);
-    g.vendorSoldCache.clear();
+    g.vendorRefreshMin = sConfigMgr->GetOption<uint32_t>(CFG_VENDOR_REFRESH_MIN, 60);
+    g.indexCacheFile = sConfigMgr->GetOption<std::string>(CFG_INDEX_CACHE_FILE, "dah_index.cache");
+    g.recipeBuildThreads = sConfigMgr->GetOption<uint32_t>(CFG_RECIPE_BUILD_THREADS, 0);
 
     g.stDefault = sConfigMgr->GetOption<uint32_t>(CFG_STACK_DEFAULT, 20u);
     g.stCloth = sConfigMgr->GetOption<uint32_t>(CFG_STACK_CLOTH, g.stDefault);
@@ -206,7 +307,16 @@ void Service::OnConfigLoad()
     g.stacksHigh = sConfigMgr->GetOption<uint32_t>(CFG_STACKS_HIGH, 2u);
 
     g.debugContextLogs = sConfigMgr->GetOption<bool>(CFG_DEBUG_CONTEXT_LOGS, false);
+    g.logDetailPerCycle = sConfigMgr->GetOption<uint32_t>(CFG_LOG_DETAIL_PER_CYCLE, 50);
+    g.traceEnabled = sConfigMgr->GetOption<bool>(CFG_TRACE_ENABLED, true);
+    FlightRecorder::SetEnabled(g.traceEnabled);
     g.loopEnabled = sConfigMgr->GetOption<bool>(CFG_LOOP_ENABLED, true);
+    g.tickBudgetUs = sConfigMgr->GetOption<uint32_t>(CFG_CYCLE_TICK_BUDGET_US, 2000u);
+    g.asyncPlanning = sConfigMgr->GetOption<bool>(CFG_PLANNER_ASYNC, true);
+    g.applyTargetSharePct = sConfigMgr->GetOption<float>(CFG_APPLY_TARGET_SHARE, 5.0f);
+    g.applyMinPerTick = sConfigMgr->GetOption<uint32_t>(CFG_APPLY_MIN_PER_TICK, 1u);
+    g.applyMaxPerTick = sConfigMgr->GetOption<uint32_t>(CFG_APPLY_MAX_PER_TICK, 100u);
+    throttle_.Configure(g.applyTargetSharePct, g.applyMinPerTick, g.applyMaxPerTick);
 
     g.caps.InitDefaults();
     g.caps.enabled = sConfigMgr->GetOption<bool>(CFG_CAP_ENABLED, true);
@@ -273,29 +383,94 @@ void Service::OnConfigLoad()
     bec.minPriceCopper = g.minPriceCopper;
     bec.scarcityEnabled = g.scarcityEnabled;
     bec.onlineCount = 0;
+    bec.ownerAlliance = g.ownerAlliance;
+    bec.ownerHorde = g.ownerHorde;
+    bec.ownerNeutral = g.ownerNeutral;
+    bec.debug = sConfigMgr->GetOption<bool>(CFG_BUY_DEBUG, false);
+    bec.logDetailPerCycle = g.logDetailPerCycle;
 
     buy_.SetConfig(bec);
-    buy_.SetFilters(g.allowQuality, g.whiteAllow);
 
     g.mulDust = sConfigMgr->GetOption<float>(CFG_PRICE_MUL_DUST, 1.0f);
     g.mulEssence = sConfigMgr->GetOption<float>(CFG_PRICE_MUL_ESSENCE, 1.25f);
     g.mulShard = sConfigMgr->GetOption<float>(CFG_PRICE_MUL_SHARD, 2.0f);
     g.mulElemental = sConfigMgr->GetOption<float>(CFG_PRICE_MUL_ELEMENTAL, 3.0f);
     g.mulRareRaw = sConfigMgr->GetOption<float>(CFG_PRICE_MUL_RARERAW, 3.0f);
-    DynamicAHDifficulty::Build();
 
-    static bool catInit = false;
-    if (!catInit)
+    // Derived caches: on a reload, only those whose inputs changed are rebuilt. DBC and the
+    // loot tables do not change while the server runs, so the profession index and drop levels
+    // are only revisited when the cache file setting moves.
+    CacheKeys const after = CacheKeys::Of(g);
+    ReloadReport report;
+
+    bool indexes = !reload || after.indexCacheFile != before.indexCacheFile;
+    ProfessionIndex::SetBuildThreads(g.recipeBuildThreads);
+    report.Run("profession-index", indexes, [&]
+               { DynamicAHIndexCache::LoadOrBuild(g.indexCacheFile); });
+
+    // one blocking query at startup; later refreshes ride the async path from OnUpdate
+    report.Run("vendor-index", !DynamicAHVendor::Loaded(), []
+               { DynamicAHVendor::LoadIndex(); });
+    report.Run("vendor-schedule", !reload || after.vendorRefreshMin != before.vendorRefreshMin, [&]
+               { nextVendorRefreshMs_ = g.vendorRefreshMin ? NowMs() + (uint64_t)g.vendorRefreshMin * MINUTE * IN_MILLISECONDS : 0; });
+    report.Run("vendor-sold", after.vendorMinMarkup != before.vendorMinMarkup ||
+                                  after.vendorConsiderBuyPrice != before.vendorConsiderBuyPrice,
+               [&]
+               { g.vendorSoldCache.clear(); });
+
+    // after the profession index: the item table copies its recipe skills
+    report.Run("item-index", indexes, []
+               { DynamicAHItemIndex::Build(); });
+
+    bool filters = !reload || after.allowQuality != before.allowQuality || after.whiteAllow != before.whiteAllow;
+    // after the item index: the pool is keyed by its generation
+    report.Run("sellable-pool", filters || indexes || after.blockTrashAndCommon != before.blockTrashAndCommon, [&]
+               { planner_.WarmPool(ToSelectionCfg(g)); });
+    report.Run("buy-filters", filters, [&]
+               { buy_.SetFilters(g.allowQuality, g.whiteAllow); });
+
+    // PriceCache::Sync flushes on the next plan when minPrice or the item table generation moved
+    report.Defer("price-cache", reload && (indexes || after.minPriceCopper != before.minPriceCopper));
+
+    if (!reload || after.intervalMin != before.intervalMin)
+        g.nextRunMs = NowMs() + 5000;
+
+    // reseed the hook-fed index on the next cycle (source or unit tracking changed)
+    bool scarcity = !reload || after.scarcityFromMemory != before.scarcityFromMemory ||
+                    after.scarcityCountUnits != before.scarcityCountUnits;
+    report.Defer("scarcity-index", scarcity);
+    if (scarcity)
+        planner_.Scarcity().StopTracking();
+
+    // A sliced cycle in flight keeps running unless a key its plan depends on moved; then it is
+    // dropped with its counters and a fresh one starts shortly.
+    bool planning = !reload || filters || after.blockTrashAndCommon != before.blockTrashAndCommon ||
+                    after.minPriceCopper != before.minPriceCopper || scarcity || indexes;
+    report.Run("cycle", planning, [&]
+               {
+                   g.tickPlanCounts.clear();
+                   g.cycle.Clear();
+                   g.caps.ResetCounts();
+                   if (stage_ != CycleStage::Idle)
+                   {
+                       stage_ = CycleStage::Idle;
+                       g.nextRunMs = NowMs() + 5000;
+                   } });
+
+    report.Log(reload);
+    configured_ = true;
+
+    if (g.asyncPlanning)
+        worker_.Start();
+    else
     {
-        DynamicAHPlanner::InitCategorySetsOnce();
-        catInit = true;
+        // turned off by a reload: a plan still in flight is dropped, the next cycle runs here
+        worker_.Stop();
+        planPending_ = false;
+        if (!g.scarcityFromMemory)
+            planner_.RequestScarcityRebuild(queryProcessor_, sWorldSessionMgr->GetActiveSessionCount()); // warm for the first cycle
     }
 
-    g.tickPlanCounts.clear();
-    g.cycle.Clear();
-    g.caps.ResetCounts();
-    g.nextRunMs = NowMs() + 5000;
-
     LOG_INFO("mod.dynamicah", "ModDynamicAH configured: seller={} every {}m; dryRun={} minPrice={}c; context={} scarcity={} cap/tick={} buy.enabled={}",
              g.enableSeller, g.intervalMin, g.dryRun, g.minPriceCopper, g.contextEnabled, g.scarcityEnabled, g.scarcityPerItemPerTickCap, bec.enabled);
 }
@@ -382,98 +557,254 @@ void Service::CmdCapsShow(ChatHandler *handler)
         handler->PSendSysMessage("{}", fam.c_str());
 }
 
-void Service::DoOneCycle()
+PriceCacheStats Service::PriceStats() const
+{
+    PriceCacheStats a = planner_.PriceStats();
+    PriceCacheStats b = worker_.PriceStats();
+    return PriceCacheStats{a.hits + b.hits, a.misses + b.misses, a.flushes + b.flushes};
+}
+
+void Service::StartCycle()
 {
     auto &g = state_;
 
     g.tickPlanCounts.clear();
     g.cycle.Clear();
+    g.cycle.onlineCount = sWorldSessionMgr->GetActiveSessionCount(); // one population for sell and buy pricing
     g.caps.ResetCounts();
 
-    planner_.BuildScarcityCache(g);
-    planner_.BuildContextPlan(ToPlannerCfg(g));
-    planner_.BuildRandomPlan(ToPlannerCfg(g));
-    // Make sure the plan posts to the AH
-    // state_.postQueue.Clear(); <- to avoid posting to the AH
-    {
-        auto allPosts = planner_.Queue().Drain(UINT32_MAX);
-        for (auto const &r : allPosts)
-            state_.postQueue.Push(r);
-    }
-    buy_.ResetCycle();
-    buy_.SetFilters(g.allowQuality, g.whiteAllow);
+    cycleCfg_ = ToPlannerCfg(g);
+    cycleTicks_ = 0;
+    cycleBusyUs_ = 0;
+    stage_ = CycleStage::Scarcity;
+}
 
-    auto fairFn = [&](uint32_t itemId, uint32_t active) -> PricingResult
-    {
-        auto *tmpl = sObjectMgr->GetItemTemplate(itemId);
-        PricingInputs pin{tmpl, active, g.cycle.onlineCount, g.minPriceCopper};
-        return DynamicAHPricing::Compute(pin);
-    };
-    auto scarceFn = [&](uint32_t itemId, AuctionHouseId house) -> uint32_t
-    { return planner_.ScarcityCount(itemId, house); };
-    auto vendorFn = [&](uint32_t itemId) -> std::pair<bool, uint32_t>
-    {
-        auto *tmpl = sObjectMgr->GetItemTemplate(itemId);
-        bool isVendor = (tmpl && tmpl->BuyPrice > 0);
-        uint32_t buy = (tmpl ? tmpl->BuyPrice : 0);
-        return {isVendor, buy};
-    };
+bool Service::PlanBuysStep(TickBudget const &budget)
+{
+    auto &g = state_;
 
-    buy_.BuildPlan(scarceFn, fairFn, vendorFn);
+    DefaultBuyPolicy policy{planner_.Scarcity(), g.cycle.onlineCount, g.minPriceCopper};
+    return buy_.PlanStep(auctions_, policy, budget);
 }
 
-void Service::OnUpdate(uint32_t /*diff*/)
+bool Service::AdvanceCycle(TickBudget const &budget)
 {
     auto &g = state_;
-    if (!g.loopEnabled)
-        return;
+    ++cycleTicks_;
 
-    uint64_t now = (uint64_t)GameTime::GetGameTimeMS().count();
-    if (now >= g.nextRunMs)
+    while (stage_ != CycleStage::Idle)
     {
-        DoOneCycle();
-        g.nextRunMs = now + (uint64_t)g.intervalMin * MINUTE * IN_MILLISECONDS;
+        switch (stage_)
+        {
+        case CycleStage::Scarcity:
+            if (cycleCfg_.scarcityFromMemory) // kept current by the auction hooks
+                planner_.SyncScarcityIndex(cycleCfg_, g.cycle.onlineCount);
+            else // never waits on MySQL: this cycle prices with the previous counts if the
+                 // aggregate has not come back yet
+                planner_.RequestScarcityRebuild(queryProcessor_, g.cycle.onlineCount);
+            planner_.BeginContextPlan(cycleCfg_);
+            stage_ = CycleStage::Context;
+            break;
+
+        case CycleStage::Context:
+            if (!planner_.StepContextPlan(cycleCfg_, budget))
+                break;
+            planner_.BeginRandomPlan(cycleCfg_);
+            stage_ = CycleStage::Random;
+            break;
+
+        case CycleStage::Random:
+            if (planner_.StepRandomPlan(cycleCfg_, budget))
+                stage_ = CycleStage::Handoff;
+            break;
+
+        case CycleStage::Handoff:
+        {
+            // Make sure the plan posts to the AH
+            // state_.postQueue.Clear(); <- to avoid posting to the AH
+            state_.postQueue.Splice(planner_.Queue());
+
+            buy_.ResetCycle();
+            buy_.SetFilters(g.allowQuality, g.whiteAllow);
+            buy_.BeginPlan();
+            buy_.RequestFunds(queryProcessor_);
+            stage_ = CycleStage::BuyPlan;
+            break;
+        }
+
+        case CycleStage::BuyPlan:
+            if (PlanBuysStep(budget))
+            {
+                stage_ = CycleStage::Idle;
+                LOG_INFO("mod.dynamicah", "cycle: done in {} tick(s), {} us of world time; posts={} buys={}",
+                         cycleTicks_, cycleBusyUs_ + budget.ElapsedUs(), state_.postQueue.Size(), buy_.QueueSize());
+            }
+            break;
+
+        default:
+            stage_ = CycleStage::Idle;
+            break;
+        }
+
+        if (budget.Exhausted())
+            break;
     }
 
-    ModDynamicAH::DynamicAHPosting::ApplyPlanOnWorld(g, 10, nullptr);
-    buy_.Apply(10, /*dry*/ g.dryRun, /*handler*/ nullptr);
+    cycleBusyUs_ += budget.ElapsedUs();
+    return stage_ == CycleStage::Idle;
 }
 
-void Service::PlanOnce(ChatHandler *handler)
+bool Service::SubmitPlanJob()
 {
     auto &g = state_;
+
+    auto job = std::make_unique<PlanJob>();
+    job->cycleId = ++cycleSeq_;
+    job->planner = ToPlannerCfg(g);
+    job->buy = buy_.Config();
+    for (size_t i = 0; i < 6; ++i)
+        job->allowQuality[i] = g.allowQuality[i];
+    job->whiteAllow = g.whiteAllow;
+    job->onlineCount = sWorldSessionMgr->GetActiveSessionCount();
+    job->buy.onlineCount = job->onlineCount; // fair buy prices use the same population as the sync path
+
+    if (job->planner.scarcityFromMemory)
+    {
+        planner_.SyncScarcityIndex(job->planner, job->onlineCount);
+        job->scarcity = planner_.Scarcity().Snapshot();
+    }
+
+    job->nowMs = clock_.NowMs();
+
+    // Copy only what the buy scan can reach (it stops at maxScanRows across A, H, N)
+    uint32_t scanLimit = job->buy.maxScanRows ? job->buy.maxScanRows : 1000;
+    if (job->buy.enabled)
+    {
+        job->auctions.reserve(scanLimit);
+        for (Core::House house : Core::Houses)
+            if (job->auctions.size() < scanLimit)
+                auctions_.ScanHouse(house, 0, scanLimit - job->auctions.size(), job->auctions);
+    }
+
+    if (!worker_.Submit(std::move(job)))
+        return false;
+
     g.tickPlanCounts.clear();
     g.cycle.Clear();
     g.caps.ResetCounts();
-    planner_.BuildScarcityCache(g);
-    planner_.BuildContextPlan(ToPlannerCfg(g));
-    planner_.BuildRandomPlan(ToPlannerCfg(g));
-    // Make sure the plan posts to the AH
-    // state_.postQueue.Clear(); <- to avoid posting to the AH
+    return true;
+}
+
+void Service::AdoptPlanResult(PlanResult &res)
+{
+    auto &g = state_;
+
+    for (auto const &r : res.posts)
+        g.postQueue.Push(r);
+
+    buy_.SetFilters(g.allowQuality, g.whiteAllow);
+    buy_.AdoptPlan(std::move(res.buys), res.buyBudgetUsed);
+    buy_.RequestFunds(queryProcessor_);
+
+    LOG_INFO("mod.dynamicah", "cycle: worker plan #{} adopted ({} us off-thread); posts={} buys={}",
+             res.cycleId, res.elapsedUs, g.postQueue.Size(), buy_.QueueSize());
+}
+
+void Service::OnShutdown()
+{
+    worker_.Stop();
+}
+
+void Service::OnUpdate(uint32_t diff)
+{
+    auto &g = state_;
+    throttle_.ObserveTick(diff);
+    queryProcessor_.ProcessReadyCallbacks();
+
+    // Results are drained even with the loop off, so a job in flight is never lost.
+    while (std::unique_ptr<PlanResult> res = worker_.Poll())
     {
-        auto batch = planner_.Queue().Drain(std::numeric_limits<uint32_t>::max());
-        for (auto &r : batch)
-            state_.postQueue.Push(std::move(r));
+        planPending_ = false;
+        AdoptPlanResult(*res);
     }
-    buy_.ResetCycle();
-    buy_.SetFilters(g.allowQuality, g.whiteAllow);
 
-    auto fairFn = [&](uint32_t itemId, uint32_t active) -> PricingResult
+    uint64_t now = (uint64_t)GameTime::GetGameTimeMS().count();
+    if (nextVendorRefreshMs_ && now >= nextVendorRefreshMs_)
     {
-        auto *tmpl = sObjectMgr->GetItemTemplate(itemId);
-        PricingInputs pin{tmpl, active, g.cycle.onlineCount, g.minPriceCopper};
-        return DynamicAHPricing::Compute(pin);
-    };
-    auto scarceFn = [&](uint32_t itemId, AuctionHouseId house) -> uint32_t
-    { return planner_.ScarcityCount(itemId, house); };
-    auto vendorFn = [&](uint32_t itemId) -> std::pair<bool, uint32_t>
+        DynamicAHVendor::RequestRefresh(queryProcessor_);
+        nextVendorRefreshMs_ = now + (uint64_t)g.vendorRefreshMin * MINUTE * IN_MILLISECONDS;
+    }
+
+    if (!g.loopEnabled)
+        return;
+
+    if (stage_ == CycleStage::Idle && !planPending_ && now >= g.nextRunMs)
     {
-        auto *tmpl = sObjectMgr->GetItemTemplate(itemId);
-        bool isVendor = (tmpl && tmpl->BuyPrice > 0);
-        uint32_t buy = (tmpl ? tmpl->BuyPrice : 0);
-        return {isVendor, buy};
-    };
-    buy_.BuildPlan(scarceFn, fairFn, vendorFn);
+        if (g.asyncPlanning && worker_.Running())
+        {
+            if (SubmitPlanJob())
+            {
+                planPending_ = true;
+                g.nextRunMs = now + (uint64_t)g.intervalMin * MINUTE * IN_MILLISECONDS;
+            }
+        }
+        else
+        {
+            StartCycle();
+            g.nextRunMs = now + (uint64_t)g.intervalMin * MINUTE * IN_MILLISECONDS;
+        }
+    }
+
+    if (stage_ != CycleStage::Idle)
+        AdvanceCycle(TickBudget(g.tickBudgetUs));
+
+    // Apply batches sized by the throttle; an empty queue is not a sample.
+    uint64_t postUs = 0;
+    if (uint32_t before = g.postQueue.Size())
+    {
+        TickBudget sw = TickBudget::Unlimited();
+        ModDynamicAH::DynamicAHPosting::ApplyPlanOnWorld(g, throttle_.PostQuota(), nullptr);
+        postUs = sw.ElapsedUs();
+        throttle_.ObservePosts(before - g.postQueue.Size(), postUs);
+    }
+
+    if (buy_.QueueSize())
+    {
+        TickBudget sw = TickBudget::Unlimited();
+        uint32_t bought = buy_.Apply(throttle_.BuyQuota(postUs), /*dry*/ g.dryRun, /*handler*/ nullptr);
+        throttle_.ObserveBuys(bought, sw.ElapsedUs());
+    }
+}
+
+void Service::OnAuctionAdd(AuctionEntry const *entry)
+{
+    if (entry)
+        planner_.Scarcity().Add(entry->houseId, entry->item_template, entry->itemCount);
+}
+
+void Service::OnAuctionRemove(AuctionEntry const *entry)
+{
+    if (entry)
+        planner_.Scarcity().Remove(entry->houseId, entry->item_template, entry->itemCount);
+}
+
+// Sales and expiries are followed by RemoveAuction in the core, which fires OnAuctionRemove;
+// counting them here as well would decrement twice.
+void Service::OnAuctionSold(AuctionEntry const * /*entry*/)
+{
+    ++auctionsSold_;
+}
+
+void Service::OnAuctionExpired(AuctionEntry const * /*entry*/)
+{
+    ++auctionsExpired_;
+}
+
+void Service::PlanOnce(ChatHandler *handler)
+{
+    // Runs a whole cycle synchronously; restarts any cycle that is still being sliced.
+    StartCycle();
+    AdvanceCycle(TickBudget::Unlimited());
 
     handler->PSendSysMessage("ModDynamicAH: Plans built. Posts: {} Buys: {}",
                              state_.postQueue.Size(), buy_.QueueSize());
@@ -505,8 +836,12 @@ void Service::ClearQueues(ChatHandler *handler)
 
 void Service::ShowQueue(ChatHandler *handler)
 {
-    handler->PSendSysMessage("ModDynamicAH: postQueue={} buyQueue={} budgetUsed={}/{}",
-                             state_.postQueue.Size(), buy_.QueueSize(), buy_.BudgetUsed(), buy_.BudgetLimit());
+    handler->PSendSysMessage("ModDynamicAH: postQueue={} (scarce={} context={} random={}) buyQueue={} budgetUsed={}/{}",
+                             state_.postQueue.Size(),
+                             state_.postQueue.LaneSize(PostLane::Scarce),
+                             state_.postQueue.LaneSize(PostLane::Context),
+                             state_.postQueue.LaneSize(PostLane::Random),
+                             buy_.QueueSize(), buy_.BudgetUsed(), buy_.BudgetLimit());
 }
 
 void Service::ToggleLoop(bool enable, ChatHandler *handler)
@@ -4,7 +4,9 @@
 #include "DynamicAHPlanner.h"
 #include "DynamicAHPosting.h"
 #include "DynamicAHState.h"
-#include "DynamicAHPosting.h"
+#include "DynamicAHCycle.h"
+#include "DynamicAHWorker.h"
+#include "DynamicAHThrottle.h"
 
 class ChatHandler;
 
@@ -17,7 +19,16 @@ namespace ModDynamicAH
 
         // lifecycle
         void OnConfigLoad();
-        void OnUpdate(uint32_t /*diff*/);
+        void OnUpdate(uint32_t diff);
+        void OnShutdown();
+
+        // auction house hooks (world thread); keep the scarcity index current
+        void OnAuctionAdd(AuctionEntry const *entry);
+        void OnAuctionRemove(AuctionEntry const *entry);
+        void OnAuctionSold(AuctionEntry const *entry);
+        void OnAuctionExpired(AuctionEntry const *entry);
+        uint64_t AuctionsSold() const { return auctionsSold_; }
+        uint64_t AuctionsExpired() const { return auctionsExpired_; }
 
         // admin operations
         void PlanOnce(ChatHandler *handler);
@@ -34,6 +45,10 @@ namespace ModDynamicAH
         ModuleState &State() { return state_; }
         DynamicAHPlanner &Planner() { return planner_; }
         DynamicAHPlanner const &Planner() const { return planner_; }
+        CycleStage Stage() const { return stage_; }
+        ApplyThrottle const &Throttle() const { return throttle_; }
+        PriceCacheStats PriceStats() const; // world + worker planners
+        char const *StageLabel() const { return planPending_ ? "worker" : CycleStageName(stage_); }
         void CmdFund(ChatHandler *handler, uint32 gold, std::string const &which);
         void CmdCapsShow(ChatHandler *handler);
         void CmdCapsEnable(ChatHandler* handler, bool on);
@@ -48,10 +63,36 @@ namespace ModDynamicAH
     private:
         Service() = default;
 
-        void DoOneCycle();
+        // Cycle state machine: StartCycle() snapshots config and rewinds to the first stage,
+        // AdvanceCycle() runs stages (or slices of them) until the budget is spent.
+        // Returns true once the cycle is back to Idle.
+        void StartCycle();
+        bool AdvanceCycle(TickBudget const &budget);
+        bool PlanBuysStep(TickBudget const &budget);
+
+        // Worker mode: snapshot -> planning thread -> adopt on the world thread
+        bool SubmitPlanJob();
+        void AdoptPlanResult(PlanResult &res);
 
         ModuleState state_;
-        ModDynamicAH::DynamicAHPlanner planner_;
+        GameClock clock_;
+        LiveAuctionSource auctions_; // sAuctionMgr's houses, for the buy scan and worker snapshots
+        ModDynamicAH::DynamicAHPlanner planner_{clock_};
         BuyEngine buy_;
+
+        CycleStage stage_ = CycleStage::Idle;
+        PlannerConfig cycleCfg_;
+        uint32_t cycleTicks_ = 0;
+        uint64_t cycleBusyUs_ = 0;
+
+        PlanningWorker worker_;
+        QueryCallbackProcessor queryProcessor_;
+        ApplyThrottle throttle_;
+        bool planPending_ = false;
+        uint64_t nextVendorRefreshMs_ = 0;
+        uint64_t auctionsSold_ = 0;
+        uint64_t auctionsExpired_ = 0;
+        uint32_t cycleSeq_ = 0;
+        bool configured_ = false; // OnConfigLoad has run; later calls are reloads
     };
 }
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace ModDynamicAH
+{
+    namespace Core
+    {
+
+        // Wall-clock budget for one slice of cycle work. A budget of 0 never runs out.
+        // Callers always complete at least one unit of work before checking it.
+        class TickBudget
+        {
+        public:
+            using Clock = std::chrono::steady_clock;
+
+            explicit TickBudget(uint32_t budgetUs) : _start(Clock::now()), _budgetUs(budgetUs) {}
+
+            static TickBudget Unlimited() { return TickBudget(0); }
+
+            uint64_t ElapsedUs() const
+            {
+                return uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - _start).count());
+            }
+
+            bool Exhausted() const { return _budgetUs && ElapsedUs() >= _budgetUs; }
+
+        private:
+            Clock::time_point _start;
+            uint32_t _budgetUs;
+        };
+
+    } // namespace Core
+} // namespace ModDynamicAH
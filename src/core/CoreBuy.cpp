@@ -0,0 +1,95 @@
+#include "CoreBuy.h"
+
+namespace ModDynamicAH
+{
+    namespace Core
+    {
+
+        BuyReason RowVerdict(BuyRules const &rules, AuctionFacts const &row)
+        {
+            if (!row.buyout)
+                return BuyReason::NoBuyout;
+            // Someone already bid: a buyout would have to outbid and refund them
+            if (row.hasBidder)
+                return BuyReason::HasBidder;
+            // Never buy back our own posts
+            if (rules.IsBot(row.owner))
+                return BuyReason::OwnAuction;
+            return BuyReason::Accepted;
+        }
+
+        bool QualityAllowed(BuyRules const &rules, BuyQualityFilter const &filter, ItemFacts const &item)
+        {
+            // Always allow explicitly allow-listed white/gray items
+            if (item.quality <= QualityNormal && filter.whiteAllow.count(item.itemId))
+                return true;
+
+            // Trade Goods (profession mats) are allowed even if white/gray.
+            if (item.itemClass == ItemClassTradeGoods)
+                return true;
+
+            // If configured to block poor/common, then block them unless allow-listed
+            if (item.quality <= QualityNormal && rules.blockTrashAndCommon)
+                return false;
+
+            if (item.quality >= QualityCount) // safety
+                return false;
+
+            return filter.allowQuality[item.quality];
+        }
+
+        bool PassesVendorSafety(BuyRules const &rules, uint32_t unitBuyout, uint32_t vendorBuy)
+        {
+            if (!rules.neverAboveVendorBuyPrice || !rules.vendorConsiderBuyPrice)
+                return true;
+
+            // If vendorBuy known and > 0, ensure we never buy above it (per unit)
+            return !(vendorBuy > 0 && unitBuyout > vendorBuy);
+        }
+
+        BuyVerdict DecideBuy(BuyRules const &rules, BuyLedger &ledger, AuctionFacts const &row,
+                             PricingResult const &fair, uint32_t vendorBuy, uint32_t sellPrice)
+        {
+            BuyVerdict v;
+
+            // Compute "fair value" for this stack (prefer buyout guidance per unit if available)
+            v.fairUnit = fair.buyout ? fair.buyout : std::max<uint32_t>(rules.minPriceCopper, sellPrice * 2);
+            v.fairStack = v.fairUnit * row.count;
+            v.unitBuyout = row.count ? row.buyout / row.count : row.buyout;
+
+            if (!PassesVendorSafety(rules, v.unitBuyout, vendorBuy))
+            {
+                v.reason = BuyReason::VendorSafety;
+                return v;
+            }
+
+            // Margin check (how much cheaper vs fair)
+            if (v.fairStack > 0 && row.buyout < v.fairStack)
+                v.margin = float(v.fairStack - row.buyout) / float(v.fairStack);
+            if (v.margin < rules.minMargin)
+            {
+                v.reason = BuyReason::Margin;
+                return v;
+            }
+
+            uint32_t &plannedForItem = ledger.perItem[row.itemId];
+            if (plannedForItem >= rules.perItemPerCycleCap)
+            {
+                v.reason = BuyReason::PerItemCap;
+                return v;
+            }
+
+            if (ledger.budgetUsed + row.buyout > rules.budgetCopper)
+            {
+                v.reason = BuyReason::Budget;
+                return v;
+            }
+
+            ++plannedForItem;
+            ledger.budgetUsed += row.buyout;
+            v.reason = BuyReason::Accepted;
+            return v;
+        }
+
+    } // namespace Core
+} // namespace ModDynamicAH
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "CorePricing.h"
+
+#include <array>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace ModDynamicAH
+{
+    namespace Core
+    {
+
+        enum class BuyReason : uint8_t
+        {
+            NoBuyout,
+            HasBidder,
+            OwnAuction,
+            NoTemplate,
+            Quality,
+            VendorSafety,
+            Margin,
+            PerItemCap,
+            Budget,
+            Accepted,
+            COUNT
+        };
+
+        inline constexpr std::array<char const *, size_t(BuyReason::COUNT)> BuyReasonNames = {
+            "no-buyout", "has-bidder", "own-auction", "no-template", "quality",
+            "vendor-safety", "margin", "per-item-cap", "budget", "accepted"};
+
+        // The settings the buy decision reads (BuyEngineConfig adds the engine's own on top)
+        struct BuyRules
+        {
+            uint64_t budgetCopper = 0;       // per-cycle budget in copper
+            float minMargin = 0.15f;         // required discount vs fair buyout (0.15 = 15%)
+            uint32_t perItemPerCycleCap = 2; // cap accepted per item per plan cycle
+            bool blockTrashAndCommon = true; // block q=poor/common unless allow-listed
+
+            // Vendor safety
+            bool vendorConsiderBuyPrice = true;   // treat BuyPrice>0 as vendor-sold
+            bool neverAboveVendorBuyPrice = true; // do not buy if unit buyout > vendor BuyPrice
+            uint32_t minPriceCopper = 10000;      // fallback min when vendor info missing
+
+            // Bot characters (guid low) per house: buys are made as them and never from them
+            uint32_t ownerAlliance = 0;
+            uint32_t ownerHorde = 0;
+            uint32_t ownerNeutral = 0;
+
+            bool IsBot(uint32_t guidLow) const
+            {
+                return guidLow && (guidLow == ownerAlliance || guidLow == ownerHorde || guidLow == ownerNeutral);
+            }
+        };
+
+        // Quality settings, kept apart from BuyRules because the allow-list is a set
+        struct BuyQualityFilter
+        {
+            bool allowQuality[QualityCount] = {false, false, true, true, true, false};
+            std::unordered_set<uint32_t> whiteAllow;
+        };
+
+        // What the decisions of one plan cycle have committed so far
+        struct BuyLedger
+        {
+            std::unordered_map<uint32_t, uint32_t> perItem; // itemId -> planned buys
+            uint64_t budgetUsed = 0;
+
+            void Reset()
+            {
+                perItem.clear();
+                budgetUsed = 0;
+            }
+        };
+
+        struct BuyVerdict
+        {
+            BuyReason reason = BuyReason::Accepted;
+            uint32_t fairUnit = 0;
+            uint32_t fairStack = 0;
+            uint32_t unitBuyout = 0;
+            float margin = 0.0f; // discount vs fair (0.15 = 15%)
+        };
+
+        // Row-only filters (no item lookup); Accepted = passes
+        BuyReason RowVerdict(BuyRules const &rules, AuctionFacts const &row);
+
+        bool QualityAllowed(BuyRules const &rules, BuyQualityFilter const &filter, ItemFacts const &item);
+
+        bool PassesVendorSafety(BuyRules const &rules, uint32_t unitBuyout, uint32_t vendorBuy);
+
+        // Vendor safety, margin, per-item cap and budget for a row that passed RowVerdict and
+        // QualityAllowed. Charges the ledger when the verdict is Accepted.
+        BuyVerdict DecideBuy(BuyRules const &rules, BuyLedger &ledger, AuctionFacts const &row,
+                             PricingResult const &fair, uint32_t vendorBuy, uint32_t sellPrice);
+
+    } // namespace Core
+} // namespace ModDynamicAH
@@ -0,0 +1,109 @@
+#include "CoreBuyPlanner.h"
+
+namespace ModDynamicAH
+{
+    namespace Core
+    {
+
+        void DefaultBuyPolicy::FairBatch(size_t n, ItemFacts const *const *items, uint32_t const *active,
+                                         PricingResult *out) const
+        {
+            std::vector<uint32_t> vendorBase(n), minPrice(n, minPriceCopper), start(n), buyout(n);
+            for (size_t i = 0; i < n; ++i)
+                vendorBase[i] = VendorBase(items[i]->sellPrice, items[i]->buyPrice);
+
+            PricingBatch b;
+            b.n = n;
+            b.vendorBase = vendorBase.data();
+            b.active = active;
+            b.minPrice = minPrice.data();
+            b.onlineCount = onlineCount;
+            b.outStart = start.data();
+            b.outBuyout = buyout.data();
+            ComputeBatch(b);
+
+            for (size_t i = 0; i < n; ++i)
+                out[i] = PricingResult{start[i], buyout[i]};
+        }
+
+        void BuyPlanner::BeginPlan()
+        {
+            _scanHouse = 0;
+            _scanAfterId = 0;
+            _counts = Counts{};
+            _memo.Reset();
+            _scanDone = !_rules.enabled;
+        }
+
+        bool BuyPlanner::PrefilterRow(AuctionFacts const &row)
+        {
+            BuyReason why = RowVerdict(_rules, row);
+            if (why == BuyReason::Accepted)
+                return true;
+
+            ++_counts.skipped;
+            Report(row, nullptr, why);
+            return false;
+        }
+
+        FairMemo::Entry &BuyPlanner::LookupItem(AuctionFacts const &row, bool &inserted)
+        {
+            FairMemo::Entry &e = _memo.Find(row.itemId, uint8_t(row.house), inserted);
+            if (inserted)
+            {
+                e.item = _catalog.Find(row.itemId);
+                e.allowed = e.item && QualityAllowed(_rules, _filter, *e.item);
+            }
+            return e;
+        }
+
+        bool BuyPlanner::AdmitItem(AuctionFacts const &row, FairMemo::Entry const &entry)
+        {
+            if (!entry.item)
+            {
+                ++_counts.skipped;
+                Report(row, nullptr, BuyReason::NoTemplate);
+                return false;
+            }
+
+            // Quality filter
+            if (!entry.allowed)
+            {
+                ++_counts.skipped;
+                Report(row, entry.item, BuyReason::Quality);
+                return false;
+            }
+
+            ++_counts.considered;
+            return true;
+        }
+
+        void BuyPlanner::DecideRow(AuctionFacts const &row, ItemFacts const &item, PricingResult const &fair,
+                                   uint32_t vendorBuy)
+        {
+            // Vendor safety, margin, per-item cap and budget; charges the ledger on accept
+            uint64_t usedBefore = _ledger.budgetUsed;
+            BuyVerdict v = DecideBuy(_rules, _ledger, row, fair, vendorBuy, item.sellPrice);
+            if (v.reason == BuyReason::Accepted)
+            {
+                BuyDecision d;
+                d.auctionId = row.id;
+                d.house = row.house;
+                d.itemId = row.itemId;
+                d.count = row.count;
+                d.buyout = row.buyout;
+                d.startBid = row.startBid;
+                d.vendorBuy = vendorBuy;
+                d.margin = v.margin;
+                _sink.Buy(d);
+                ++_counts.accepted;
+            }
+            else
+                ++_counts.skipped;
+
+            if (_observer)
+                _observer->Decided(row, &item, v, vendorBuy, usedBefore);
+        }
+
+    } // namespace Core
+} // namespace ModDynamicAH
@@ -0,0 +1,284 @@
+#pragma once
+
+#include "CoreBudget.h"
+#include "CoreBuy.h"
+#include "CoreFairMemo.h"
+#include "CoreInterfaces.h"
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+namespace ModDynamicAH
+{
+    namespace Core
+    {
+
+        // BuyRules plus the scan settings (BuyEngineConfig adds the engine's own on top)
+        struct BuyScanRules : BuyRules
+        {
+            bool enabled = false;
+            uint32_t maxScanRows = 2000; // rows per plan; 0 = 1000
+        };
+
+        //------------------------------------------------------------------------------------------
+        // Scan policies. Any type with these members can drive a plan:
+        //   uint32_t Scarcity(uint32_t itemId, House house)            active count in that AH
+        //   PricingResult Fair(ItemFacts const &item, uint32_t active) unit guidance
+        //   uint32_t VendorBuy(ItemFacts const &item)                  vendor BuyPrice, 0 if none
+        // and optionally, to price a whole snapshot at once before the scan:
+        //   void FairBatch(size_t n, ItemFacts const *const *items, uint32_t const *active, PricingResult *out)
+        // They are template parameters of the scan so the calls inline. The planner looks the item
+        // up itself and memoizes Fair/VendorBuy per (item, house) for the cycle, so a policy is
+        // called once per distinct item rather than once per row.
+        //------------------------------------------------------------------------------------------
+        struct DefaultBuyPolicy
+        {
+            IScarcitySource const &scarcity;
+            uint32_t onlineCount = 0;
+            uint32_t minPriceCopper = 10000;
+
+            uint32_t Scarcity(uint32_t itemId, House house) const { return scarcity.ActiveCount(itemId, house); }
+            PricingResult Fair(ItemFacts const &item, uint32_t active) const
+            {
+                return ComputeUnit(VendorBase(item.sellPrice, item.buyPrice), active, onlineCount, minPriceCopper);
+            }
+            uint32_t VendorBuy(ItemFacts const &item) const { return item.buyPrice; }
+
+            void FairBatch(size_t n, ItemFacts const *const *items, uint32_t const *active, PricingResult *out) const;
+        };
+
+        template <typename Policy, typename = void>
+        struct HasFairBatch : std::false_type
+        {
+        };
+
+        template <typename Policy>
+        struct HasFairBatch<Policy, std::void_t<decltype(std::declval<Policy &>().FairBatch(
+                                        size_t(0), static_cast<ItemFacts const *const *>(nullptr),
+                                        static_cast<uint32_t const *>(nullptr), static_cast<PricingResult *>(nullptr)))>>
+            : std::true_type
+        {
+        };
+
+        // Every row decision of a scan, for hosts that trace or log them
+        class IBuyObserver
+        {
+        public:
+            virtual ~IBuyObserver() = default;
+
+            // `item` is null for the row-only reasons and NoTemplate; budgetBefore is the ledger's
+            // spend before the decision.
+            virtual void Decided(AuctionFacts const &row, ItemFacts const *item, BuyVerdict const &verdict,
+                                 uint32_t vendorBuy, uint64_t budgetBefore) = 0;
+        };
+
+        // Buy side of a cycle: scans the auction source (house order Alliance, Horde, Neutral,
+        // ascending id) up to maxScanRows, decides every row against the ledger and hands accepted
+        // buys to the sink. Rules are read by reference, so setting changes apply to the next row.
+        class BuyPlanner
+        {
+        public:
+            struct Counts
+            {
+                uint32_t scanned = 0;
+                uint32_t considered = 0; // item known and allowed
+                uint32_t accepted = 0;
+                uint32_t skipped = 0;
+            };
+
+            BuyPlanner(BuyScanRules const &rules, IItemCatalog const &catalog, IPersistenceSink &sink)
+                : _rules(rules), _catalog(catalog), _sink(sink)
+            {
+            }
+            BuyPlanner(BuyPlanner const &) = delete;
+            BuyPlanner &operator=(BuyPlanner const &) = delete;
+
+            void SetObserver(IBuyObserver *observer) { _observer = observer; }
+            void SetFilter(BuyQualityFilter const &filter)
+            {
+                _filter = filter;
+                _memo.Reset(); // cached verdicts depend on the filter
+            }
+
+            // per-item counts and budget committed this cycle (kept across plans until reset)
+            BuyLedger &Ledger() { return _ledger; }
+            BuyLedger const &Ledger() const { return _ledger; }
+
+            // Rewinds the scan cursor, counters and memo. With the rules disabled the plan is done
+            // right away.
+            void BeginPlan();
+            // Scans until the budget runs out; true once every house was scanned (or the row limit
+            // hit). The cursor is an auction id rather than a position, so auctions added or
+            // removed between steps cannot invalidate it.
+            template <typename Policy>
+            bool PlanStep(IAuctionSource &source, Policy &policy, TickBudget const &budget);
+            template <typename Policy>
+            void BuildPlan(IAuctionSource &source, Policy &policy)
+            {
+                BeginPlan();
+                PlanStep(source, policy, TickBudget::Unlimited());
+            }
+            // Scans pre-copied rows (scan order A, H, N) instead of a source, so it can run off
+            // the thread that owns the auctions. Policies with FairBatch price them up front.
+            template <typename Policy>
+            void BuildPlanFromRows(std::vector<AuctionFacts> const &rows, Policy &policy);
+
+            bool Done() const { return _scanDone; }
+            void Finish() { _scanDone = true; } // a plan adopted from elsewhere needs no scan
+            Counts const &Stats() const { return _counts; }
+            size_t Items() const { return _memo.Size(); } // distinct (item, house) seen this plan
+
+        private:
+            static constexpr size_t ScanChunk = 256; // rows fetched per ScanHouse call
+
+            uint32_t ScanLimit() const { return _rules.maxScanRows ? _rules.maxScanRows : 1000; }
+
+            // Row scan split around the policy calls: row filters, memoized item lookup + item
+            // filters, then the decision.
+            bool PrefilterRow(AuctionFacts const &row);
+            FairMemo::Entry &LookupItem(AuctionFacts const &row, bool &inserted);
+            bool AdmitItem(AuctionFacts const &row, FairMemo::Entry const &entry);
+            void DecideRow(AuctionFacts const &row, ItemFacts const &item, PricingResult const &fair, uint32_t vendorBuy);
+            void Report(AuctionFacts const &row, ItemFacts const *item, BuyReason reason)
+            {
+                BuyVerdict v;
+                v.reason = reason;
+                if (_observer)
+                    _observer->Decided(row, item, v, 0, _ledger.budgetUsed);
+            }
+
+            template <typename Policy>
+            void ScanRow(AuctionFacts const &row, Policy &policy)
+            {
+                if (!PrefilterRow(row))
+                    return;
+
+                bool inserted = false;
+                FairMemo::Entry &e = LookupItem(row, inserted);
+                if (inserted && e.allowed)
+                {
+                    // first row of this (item, house) this cycle: price it once
+                    e.fair = policy.Fair(*e.item, policy.Scarcity(row.itemId, row.house));
+                    e.vendorBuy = policy.VendorBuy(*e.item);
+                }
+
+                if (!AdmitItem(row, e))
+                    return;
+                DecideRow(row, *e.item, e.fair, e.vendorBuy);
+            }
+
+            // Fills the memo for the first `count` rows with one FairBatch call
+            template <typename Policy>
+            void PrimeFair(std::vector<AuctionFacts> const &rows, size_t count, Policy &policy);
+
+            BuyScanRules const &_rules;
+            IItemCatalog const &_catalog;
+            IPersistenceSink &_sink;
+            IBuyObserver *_observer = nullptr;
+
+            BuyQualityFilter _filter;
+            BuyLedger _ledger;
+            FairMemo _memo; // (item, house) -> facts, verdict, prices; reset per plan
+
+            // Scan cursor (resumable across steps): house index into the scan order + last auction id seen
+            uint8_t _scanHouse = 0;
+            uint32_t _scanAfterId = 0;
+            bool _scanDone = true;
+            std::vector<AuctionFacts> _chunk;
+            Counts _counts;
+        };
+
+        template <typename Policy>
+        bool BuyPlanner::PlanStep(IAuctionSource &source, Policy &policy, TickBudget const &budget)
+        {
+            if (_scanDone)
+                return true;
+
+            uint32_t scanLimit = ScanLimit();
+            while (_scanHouse < 3 && _counts.scanned < scanLimit)
+            {
+                size_t want = std::min<size_t>(ScanChunk, scanLimit - _counts.scanned);
+                _chunk.clear();
+                size_t got = source.ScanHouse(Houses[_scanHouse], _scanAfterId, want, _chunk);
+                for (AuctionFacts const &row : _chunk)
+                {
+                    _scanAfterId = row.id;
+                    ++_counts.scanned;
+                    ScanRow(row, policy);
+
+                    if (budget.Exhausted())
+                        return false;
+                }
+
+                if (got < want)
+                {
+                    ++_scanHouse;
+                    _scanAfterId = 0;
+                }
+            }
+
+            _scanDone = true;
+            return true;
+        }
+
+        template <typename Policy>
+        void BuyPlanner::BuildPlanFromRows(std::vector<AuctionFacts> const &rows, Policy &policy)
+        {
+            BeginPlan();
+            if (_scanDone)
+                return;
+
+            uint32_t scanLimit = ScanLimit();
+            if constexpr (HasFairBatch<Policy>::value)
+                PrimeFair(rows, std::min<size_t>(rows.size(), scanLimit), policy);
+
+            for (AuctionFacts const &row : rows)
+            {
+                if (_counts.scanned >= scanLimit)
+                    break;
+                ++_counts.scanned;
+                ScanRow(row, policy);
+            }
+
+            _scanDone = true;
+        }
+
+        template <typename Policy>
+        void BuyPlanner::PrimeFair(std::vector<AuctionFacts> const &rows, size_t count, Policy &policy)
+        {
+            std::vector<AuctionFacts const *> firsts;
+            std::vector<ItemFacts const *> items;
+            std::vector<uint32_t> active;
+            for (size_t i = 0; i < count; ++i)
+            {
+                AuctionFacts const &row = rows[i];
+                if (RowVerdict(_rules, row) != BuyReason::Accepted)
+                    continue;
+
+                bool inserted = false;
+                FairMemo::Entry &e = LookupItem(row, inserted);
+                if (!inserted || !e.allowed)
+                    continue;
+                firsts.push_back(&row);
+                items.push_back(e.item);
+                active.push_back(policy.Scarcity(row.itemId, row.house));
+            }
+            if (firsts.empty())
+                return;
+
+            std::vector<PricingResult> fair(firsts.size());
+            policy.FairBatch(firsts.size(), items.data(), active.data(), fair.data());
+
+            // the scan finds these entries already present and skips the per-item policy calls
+            for (size_t i = 0; i < firsts.size(); ++i)
+            {
+                bool inserted = false;
+                FairMemo::Entry &e = LookupItem(*firsts[i], inserted);
+                e.fair = fair[i];
+                e.vendorBuy = policy.VendorBuy(*e.item);
+            }
+        }
+
+    } // namespace Core
+} // namespace ModDynamicAH
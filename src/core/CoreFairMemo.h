@@ -0,0 +1,114 @@
+#pragma once
+
+#include "CorePricing.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace ModDynamicAH
+{
+    namespace Core
+    {
+
+        // Per-cycle memo of everything the buy scan derives from (item, house) alone: item facts,
+        // quality verdict, fair unit price and vendor price. Open addressing with linear probing;
+        // Reset() is O(1) (generation bump), so the table is reused across cycles without clearing.
+        class FairMemo
+        {
+        public:
+            struct Entry
+            {
+                uint64_t key = 0;
+                uint32_t gen = 0; // occupied when equal to the memo's current generation
+                bool allowed = false; // item exists and passes the quality filter
+                ItemFacts const *item = nullptr;
+                PricingResult fair;
+                uint32_t vendorBuy = 0;
+            };
+
+            // Forget every entry (start of a plan cycle)
+            void Reset()
+            {
+                _size = 0;
+                if (++_gen == 0) // wrapped: stale stamps could alias the new generation
+                {
+                    for (size_t i = 0; i < _cap; ++i)
+                        _slots[i].gen = 0;
+                    _gen = 1;
+                }
+            }
+
+            // Returns the entry for (itemId, house); inserted tells whether it is new (caller fills it).
+            // The reference stays valid until the next Find.
+            Entry &Find(uint32_t itemId, uint8_t house, bool &inserted)
+            {
+                if ((_size + 1) * 2 > _cap)
+                    Grow();
+
+                uint64_t key = (uint64_t(itemId) << 8) | house;
+                for (size_t i = Slot(key);; i = (i + 1) & (_cap - 1))
+                {
+                    Entry &e = _slots[i];
+                    if (e.gen != _gen)
+                    {
+                        e = Entry{};
+                        e.key = key;
+                        e.gen = _gen;
+                        ++_size;
+                        inserted = true;
+                        return e;
+                    }
+                    if (e.key == key)
+                    {
+                        inserted = false;
+                        return e;
+                    }
+                }
+            }
+
+            size_t Size() const { return _size; }
+
+        private:
+            size_t Slot(uint64_t key) const
+            {
+                // Fibonacci hashing: item ids are dense and small, so spread them over the high bits
+                return size_t((key * 0x9E3779B97F4A7C15ull) >> (64 - _bits)) & (_cap - 1);
+            }
+
+            void Grow()
+            {
+                size_t oldCap = _cap;
+                std::unique_ptr<Entry[]> old = std::move(_slots);
+
+                _bits = _cap ? _bits + 1 : 10;
+                _cap = size_t(1) << _bits;
+                _slots.reset(new Entry[_cap]);
+                _size = 0;
+
+                uint32_t gen = _gen;
+                for (size_t i = 0; i < oldCap; ++i)
+                {
+                    if (old[i].gen != gen)
+                        continue;
+                    for (size_t j = Slot(old[i].key);; j = (j + 1) & (_cap - 1))
+                    {
+                        if (_slots[j].gen != gen)
+                        {
+                            _slots[j] = old[i];
+                            ++_size;
+                            break;
+                        }
+                    }
+                }
+            }
+
+            std::unique_ptr<Entry[]> _slots;
+            size_t _cap = 0; // always 0 or a power of two
+            size_t _size = 0;
+            uint32_t _bits = 0;
+            uint32_t _gen = 1;
+        };
+
+    } // namespace Core
+} // namespace ModDynamicAH
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "CorePostQueue.h"
+#include "CoreTypes.h"
+
+#include <functional>
+#include <vector>
+
+namespace ModDynamicAH
+{
+    namespace Core
+    {
+
+        // Item templates the module may price, post or buy
+        class IItemCatalog
+        {
+        public:
+            virtual ~IItemCatalog() = default;
+
+            // nullptr when the item does not exist; the pointer stays valid until Generation() changes
+            virtual ItemFacts const *Find(uint32_t itemId) const = 0;
+
+            // Every item, in ascending item id
+            virtual void ForEach(std::function<void(ItemFacts const &)> const &fn) const = 0;
+
+            // Changes whenever the items or their facts do; never 0. Keys the planners' caches.
+            virtual uint32_t Generation() const = 0;
+        };
+
+        // Current auctions of all three houses
+        class IAuctionSource
+        {
+        public:
+            virtual ~IAuctionSource() = default;
+
+            // Replaces `out` with a copy of every live auction (house order Alliance, Horde, Neutral)
+            virtual void Snapshot(std::vector<AuctionFacts> &out) = 0;
+
+            // Appends up to maxRows auctions of `house` with an id above afterId, in ascending id;
+            // returns how many it appended. Fewer than maxRows means the house is exhausted.
+            virtual size_t ScanHouse(House house, uint32_t afterId, size_t maxRows, std::vector<AuctionFacts> &out) = 0;
+        };
+
+        // Active auction counts the prices scale with
+        class IScarcitySource
+        {
+        public:
+            virtual ~IScarcitySource() = default;
+
+            virtual uint32_t ActiveCount(uint32_t itemId, House house) const = 0;
+            virtual uint32_t OnlineCount() const = 0;
+        };
+
+        class IClock
+        {
+        public:
+            virtual ~IClock() = default;
+
+            virtual uint64_t NowMs() const = 0;
+            virtual uint32_t NowSec() const = 0; // seeds the random selection and the price jitter
+        };
+
+        struct PostDecision
+        {
+            House house = House::Neutral;
+            uint32_t itemId = 0;
+            uint32_t count = 1;
+            uint32_t startBid = 0; // whole stack
+            uint32_t buyout = 0;
+            PostLane lane = PostLane::Context;
+            uint32_t duration = 24 * 3600; // seconds
+        };
+
+        struct BuyDecision
+        {
+            uint32_t auctionId = 0;
+            House house = House::Neutral;
+            uint32_t itemId = 0;
+            uint32_t count = 1;
+            uint32_t buyout = 0;   // whole stack
+            uint32_t startBid = 0; // whole stack
+            uint32_t vendorBuy = 0; // unit
+            float margin = 0.0f;
+        };
+
+        // Where accepted decisions go (the worldserver queues them; stubs record them)
+        class IPersistenceSink
+        {
+        public:
+            virtual ~IPersistenceSink() = default;
+
+            virtual void Post(PostDecision const &d) = 0;
+            virtual void Buy(BuyDecision const &d) = 0;
+        };
+
+    } // namespace Core
+} // namespace ModDynamicAH
@@ -0,0 +1,177 @@
+#pragma once
+// Compile-time views over the ProfessionMats.h tables: every listed material once, with its
+// family and pricing category, sorted for lookup; plus the context planner's sweep order.
+
+#include "CoreTypes.h"
+#include "ProfessionMats.h"
+
+#include <array>
+#include <cstddef>
+
+namespace ModDynamicAH
+{
+    namespace Core
+    {
+
+        // One listed material
+        struct MatInfo
+        {
+            uint32_t itemId = 0;
+            Family family = Family::Other;
+            MatCategory category = MatCategory::None;
+        };
+
+        namespace MatTables
+        {
+            struct Source
+            {
+                MatBracket const *brackets;
+                size_t n;
+                Family family;
+                MatCategory category;
+            };
+
+            template <size_t N>
+            constexpr Source From(std::array<MatBracket, N> const &tab, Family fam, MatCategory cat = MatCategory::None)
+            {
+                return Source{tab.data(), N, fam, cat};
+            }
+
+            // Precedence order: an item listed twice keeps the first family and the first category.
+            // The first twelve are the families the context planner sweeps, in its order.
+            inline constexpr Source Sources[] = {
+                From(TAILORING_CLOTH, Family::Cloth),
+                From(HERBS, Family::Herb),
+                From(MINING_ORE, Family::Ore),
+                From(BS_BARS, Family::Bar),
+                From(ENCH_DUSTS, Family::Dust),
+                From(ENCH_ESSENCE, Family::Essence, MatCategory::Essence),
+                From(ENCH_SHARDS, Family::Shard, MatCategory::Shard),
+                From(LEATHERS, Family::Leather),
+                From(MINING_STONE, Family::Stone),
+                From(COOKING_MEAT, Family::Meat),
+                From(FISHING_RAW, Family::Fish),
+                From(JEWELCRAFT_GEMS, Family::Jewelcrafting),
+                From(ELEMENTALS, Family::Elemental, MatCategory::Elemental),
+                From(RARE_RAW, Family::Other, MatCategory::RareRaw),
+            };
+            inline constexpr size_t SourceCount = sizeof(Sources) / sizeof(Sources[0]);
+            inline constexpr size_t ContextSourceCount = 12;
+
+            constexpr size_t TotalListed(size_t sources)
+            {
+                size_t n = 0;
+                for (size_t s = 0; s < sources; ++s)
+                    for (size_t b = 0; b < Sources[s].n; ++b)
+                        n += Sources[s].brackets[b].items.size();
+                return n;
+            }
+
+            // every listing of the first `S` sources, duplicates included
+            template <size_t S>
+            constexpr std::array<MatInfo, TotalListed(S)> Listed()
+            {
+                std::array<MatInfo, TotalListed(S)> out{};
+                size_t k = 0;
+                for (size_t s = 0; s < S; ++s)
+                    for (size_t b = 0; b < Sources[s].n; ++b)
+                        for (uint32_t id : Sources[s].brackets[b].items)
+                            out[k++] = MatInfo{id, Sources[s].family, Sources[s].category};
+                return out;
+            }
+
+            // Folds repeats into their first listing (in place, order kept); returns the unique count.
+            constexpr size_t Merge(MatInfo *a, size_t n)
+            {
+                size_t out = 0;
+                for (size_t i = 0; i < n; ++i)
+                {
+                    size_t j = 0;
+                    while (j < out && a[j].itemId != a[i].itemId)
+                        ++j;
+                    if (j == out)
+                        a[out++] = a[i];
+                    else
+                    {
+                        if (a[j].family == Family::Other)
+                            a[j].family = a[i].family;
+                        if (a[j].category == MatCategory::None)
+                            a[j].category = a[i].category;
+                    }
+                }
+                return out;
+            }
+
+            template <size_t S>
+            constexpr size_t UniqueCount()
+            {
+                auto a = Listed<S>();
+                return Merge(a.data(), a.size());
+            }
+
+            template <size_t S>
+            constexpr std::array<MatInfo, UniqueCount<S>()> Unique()
+            {
+                auto a = Listed<S>();
+                Merge(a.data(), a.size());
+                std::array<MatInfo, UniqueCount<S>()> out{};
+                for (size_t i = 0; i < out.size(); ++i)
+                    out[i] = a[i];
+                return out;
+            }
+
+            template <size_t N>
+            constexpr std::array<MatInfo, N> SortedById(std::array<MatInfo, N> a)
+            {
+                for (size_t i = 1; i < N; ++i)
+                    for (size_t j = i; j > 0 && a[j - 1].itemId > a[j].itemId; --j)
+                    {
+                        MatInfo t = a[j - 1];
+                        a[j - 1] = a[j];
+                        a[j] = t;
+                    }
+                return a;
+            }
+        } // namespace MatTables
+
+        // Every listed material once, ascending item id
+        inline constexpr auto MAT_INDEX = MatTables::SortedById(MatTables::Unique<MatTables::SourceCount>());
+
+        // The context planner's sweep: each material of the twelve family tables once, in table order
+        inline constexpr auto CONTEXT_MATS = MatTables::Unique<MatTables::ContextSourceCount>();
+
+        // Binary search over MAT_INDEX; nullptr if the item is not a listed material
+        constexpr MatInfo const *FindMat(uint32_t itemId)
+        {
+            size_t lo = 0, hi = MAT_INDEX.size();
+            while (lo < hi)
+            {
+                size_t mid = lo + (hi - lo) / 2;
+                if (MAT_INDEX[mid].itemId < itemId)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            return (lo < MAT_INDEX.size() && MAT_INDEX[lo].itemId == itemId) ? &MAT_INDEX[lo] : nullptr;
+        }
+
+        constexpr Family MatFamily(uint32_t itemId)
+        {
+            MatInfo const *m = FindMat(itemId);
+            return m ? m->family : Family::Other;
+        }
+
+        constexpr MatCategory MatCategoryOf(uint32_t itemId)
+        {
+            MatInfo const *m = FindMat(itemId);
+            return m ? m->category : MatCategory::None;
+        }
+
+        static_assert(MatFamily(2589) == Family::Cloth, "Linen Cloth");
+        static_assert(MatCategoryOf(10998) == MatCategory::Essence, "essence wins over shard");
+        static_assert(MatFamily(33568) == Family::Leather && MatCategoryOf(33568) == MatCategory::RareRaw,
+                      "Borean Leather: leather family, rare-raw multiplier");
+        static_assert(MatFamily(0) == Family::Other, "no item 0");
+
+    } // namespace Core
+} // namespace ModDynamicAH
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "DynamicAHRingBuffer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace ModDynamicAH
+{
+    namespace Core
+    {
+
+        // Drain order of the post queue: items missing from a house first, then profession
+        // materials, then random sellables.
+        enum class PostLane : uint8_t
+        {
+            Scarce = 0,
+            Context,
+            Random,
+            COUNT
+        };
+
+        // FIFO per lane; lanes drain in PostLane order. Request is any type with a PostLane `lane`
+        // member (the module's PostRequest; tools use their own).
+        template <typename Request>
+        class LaneQueue
+        {
+        public:
+            void Push(Request r)
+            {
+                size_t lane = std::min<size_t>(size_t(r.lane), size_t(PostLane::COUNT) - 1);
+                _lanes[lane].Push(std::move(r));
+            }
+
+            // Fills out[0..cap) without allocating; returns the number written.
+            uint32_t DrainInto(Request *out, uint32_t cap)
+            {
+                uint32_t n = 0;
+                for (auto &lane : _lanes)
+                {
+                    if (n == cap)
+                        break;
+                    n += uint32_t(lane.PopInto(out + n, cap - n));
+                }
+                return n;
+            }
+
+            std::vector<Request> Drain(uint32_t max)
+            {
+                std::vector<Request> out(std::min(max, Size()));
+                out.resize(DrainInto(out.data(), uint32_t(out.size())));
+                return out;
+            }
+
+            // Moves everything from `from`, keeping lanes and order.
+            void Splice(LaneQueue &from)
+            {
+                Request buf[64];
+                while (uint32_t n = from.DrainInto(buf, 64))
+                    for (uint32_t i = 0; i < n; ++i)
+                        Push(std::move(buf[i]));
+            }
+
+            uint32_t Size() const
+            {
+                size_t n = 0;
+                for (auto const &lane : _lanes)
+                    n += lane.Size();
+                return uint32_t(n);
+            }
+            uint32_t LaneSize(PostLane lane) const { return uint32_t(_lanes[size_t(lane)].Size()); }
+            void Clear()
+            {
+                for (auto &lane : _lanes)
+                    lane.Clear();
+            }
+
+        private:
+            RingBuffer<Request> _lanes[size_t(PostLane::COUNT)];
+        };
+
+    } // namespace Core
+} // namespace ModDynamicAH
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "CorePricePolicy.h"
+
+#include <atomic>
+#include <vector>
+
+namespace ModDynamicAH
+{
+    namespace Core
+    {
+
+        struct PriceCacheStats
+        {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            uint64_t flushes = 0; // whole-cache drops (pricing config or item catalog changed)
+        };
+
+        // Cross-cycle cache of the count-independent inputs of PriceWithPolicies (PriceParts). The
+        // engine price (scarcity and population factors), category multiplier, jitter, rounding and
+        // the floors/ceiling still run on every call, so a changed active or online count never
+        // misses. Indexed densely by item id; none of these inputs depends on the house, so one
+        // entry serves all three.
+        //
+        // The family only matters as mat / not a mat (BoundsFor), so each item holds one entry per
+        // kind and an item planned both ways does not evict itself. The whole cache is dropped when
+        // the only rule it folds in (minPriceCopper) or the catalog generation changes.
+        class PriceCache
+        {
+        public:
+            // Call before Find with the current inputs; flushes when they differ from the last call.
+            void Sync(uint32_t catalogGeneration, uint32_t minPriceCopper)
+            {
+                if (catalogGeneration == _catalogGen && minPriceCopper == _minPrice)
+                    return;
+                if (_catalogGen)
+                    _flushes.fetch_add(1, std::memory_order_relaxed);
+                _catalogGen = catalogGeneration;
+                _minPrice = minPriceCopper;
+                _entries.clear();
+            }
+
+            // Cached parts for this item and family kind, or nullptr (caller computes and calls Store).
+            PriceParts const *Find(uint32_t itemId, Family fam)
+            {
+                size_t i = Index(itemId, fam);
+                if (i >= _entries.size() || !_entries[i].valid)
+                {
+                    _misses.fetch_add(1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+                _hits.fetch_add(1, std::memory_order_relaxed);
+                return &_entries[i].parts;
+            }
+
+            void Store(uint32_t itemId, Family fam, PriceParts const &parts)
+            {
+                size_t i = Index(itemId, fam);
+                if (i >= _entries.size())
+                    _entries.resize((size_t(itemId) + 1) * 2); // both kinds of this item
+                _entries[i].parts = parts;
+                _entries[i].valid = true;
+            }
+
+            // Safe from any thread (counters only)
+            PriceCacheStats Stats() const
+            {
+                return PriceCacheStats{_hits.load(std::memory_order_relaxed),
+                                       _misses.load(std::memory_order_relaxed),
+                                       _flushes.load(std::memory_order_relaxed)};
+            }
+
+        private:
+            struct Entry
+            {
+                PriceParts parts;
+                bool valid = false;
+            };
+
+            static size_t Index(uint32_t itemId, Family fam)
+            {
+                return size_t(itemId) * 2 + (fam != Family::Other ? 1 : 0);
+            }
+
+            std::vector<Entry> _entries;
+            uint32_t _catalogGen = 0; // IItemCatalog::Generation; 0 = never synced
+            uint32_t _minPrice = 0;
+            std::atomic<uint64_t> _hits{0};
+            std::atomic<uint64_t> _misses{0};
+            std::atomic<uint64_t> _flushes{0};
+        };
+
+    } // namespace Core
+} // namespace ModDynamicAH
@@ -0,0 +1,173 @@
+#include "CorePricePolicy.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ModDynamicAH
+{
+    namespace Core
+    {
+
+        RecipeBounds BoundsFor(PriceRules const &rules, Family fam, uint16_t req, uint16_t maxReq, uint32_t stackSize)
+        {
+            RecipeBounds out;
+            out.minPrice = rules.minPriceCopper; // may be overridden for stackable mats below
+
+            // ---- Recipe-driven bounds (per STACK) ----
+            if (req > 450)
+                req = 450;
+            if (maxReq > 450)
+                maxReq = 450;
+
+            auto lerp = [](double a, double b, double t)
+            { return a + (b - a) * std::clamp(t, 0.0, 1.0); };
+
+            auto stackBaseFloorG = [req, lerp]() -> double
+            {
+                // Floors per stack tuned for low tiers:
+                // 0..75: 0.4..0.8g, 75..150: 0.8..1.6g, 150..225: 1.6..4g,
+                // 225..300: 4..12g, 300..375: 12..30g, 375..450: 30..60g
+                if (req <= 75)
+                    return lerp(0.4, 0.8, double(req) / 75.0);
+                if (req <= 150)
+                    return lerp(0.8, 1.6, double(req - 75) / 75.0);
+                if (req <= 225)
+                    return lerp(1.6, 4.0, double(req - 150) / 75.0);
+                if (req <= 300)
+                    return lerp(4.0, 12.0, double(req - 225) / 75.0);
+                if (req <= 375)
+                    return lerp(12.0, 30.0, double(req - 300) / 75.0);
+                return lerp(30.0, 60.0, double(req - 375) / 75.0);
+            };
+
+            // modest premium if many high-tier recipes also use it
+            double spread = std::max(0, int(maxReq) - int(req));        // 0..450
+            double boost = std::clamp(spread / 200.0, 0.0, 1.0) * 0.20; // up to +20%
+
+            bool isStackableMat =
+                (stackSize > 1) && (fam != Family::Other); // treat mats (cloth/ore/herb/etc.) specially
+
+            uint32_t recipeUnitFloor = 0;
+            uint32_t recipeUnitCeil = 0;
+
+            if (req > 0)
+            {
+                double floorG = stackBaseFloorG() * (1.0 + boost);
+                // ceilings: allow more headroom at higher tiers
+                double spanMul =
+                    (req <= 150) ? 2.0 : (req <= 300) ? 2.5
+                                                      : 3.0;
+                double ceilG = floorG * spanMul;
+
+                recipeUnitFloor = uint32_t(std::lround(floorG * 10000.0 / double(stackSize)));
+                recipeUnitCeil = uint32_t(std::lround(ceilG * 10000.0 / double(stackSize)));
+
+                // For stackable mats, use recipe floor as the effective min so low tiers stay cheap.
+                if (isStackableMat)
+                    out.minPrice = std::max<uint32_t>(recipeUnitFloor, 100u); // at least 1s
+                else
+                    out.minPrice = std::max<uint32_t>(out.minPrice, recipeUnitFloor);
+            }
+
+            out.unitCeil = recipeUnitCeil;
+            out.stackableMat = isStackableMat;
+            return out;
+        }
+
+        PriceParts PartsFor(PriceRules const &rules, Family fam, ItemFacts const &item)
+        {
+            RecipeBounds bounds = BoundsFor(rules, fam, item.recipeEff, item.recipeMax, std::max<uint32_t>(1u, item.stackable));
+            PriceParts out;
+            out.vendorBase = VendorBase(item.sellPrice, item.buyPrice);
+            out.minPrice = bounds.minPrice;
+            out.recipeUnitCeil = bounds.unitCeil;
+            out.stackableMat = bounds.stackableMat;
+            return out;
+        }
+
+        double CategoryMul(PriceRules const &rules, MatCategory cat)
+        {
+            switch (cat)
+            {
+            case MatCategory::Essence:
+                return rules.mulEssence;
+            case MatCategory::Shard:
+                return rules.mulShard;
+            case MatCategory::Elemental:
+                return rules.mulElemental;
+            case MatCategory::RareRaw:
+                return rules.mulRareRaw;
+            default:
+                return 1.0;
+            }
+        }
+
+        double Jitter(uint32_t nowSec, uint32_t itemId)
+        {
+            uint32_t seed = nowSec ^ (itemId * 2654435761u);
+            int delta = int(seed % 11) - 5; // -5..+5
+            return 1.0 + double(delta) / 100.0;
+        }
+
+        void ApplyVendorFloor(uint32_t vendorBuyPrice, uint32_t &startBid, uint32_t &buyout,
+                              uint32_t minPriceCopper, double vendorMinMarkup)
+        {
+            if (vendorBuyPrice == 0)
+            {
+                startBid = std::max(startBid, minPriceCopper);
+                buyout = std::max(buyout, std::max(startBid, minPriceCopper));
+                return;
+            }
+
+            uint32_t floorV = std::max<uint32_t>(minPriceCopper, uint32_t(double(vendorBuyPrice) * (1.0 + vendorMinMarkup)));
+            startBid = std::max(startBid, floorV);
+            buyout = std::max(buyout, std::max(startBid, floorV));
+        }
+
+        PricingResult ApplyPolicies(PriceRules const &rules, ItemFacts const &item, PriceParts const &parts,
+                                    PricingResult const &engine, uint32_t active, uint32_t nowSec)
+        {
+            uint32_t unitStart = engine.startBid;
+            uint32_t unitBuy = std::max<uint32_t>(engine.buyout, unitStart + 1);
+
+            // ---- Scarcity/category/jitter (unit) ----
+            auto mulRound = [](uint32_t v, double f) -> uint32_t
+            { return uint32_t(std::lround(double(v) * f)); };
+            double scarcityBoost = rules.scarcityEnabled ? (1.0 + rules.scarcityPriceBoostMax / double(1 + active)) : 1.0;
+            double catMul = CategoryMul(rules, item.category);
+            double jitter = Jitter(nowSec, item.itemId);
+
+            unitStart = mulRound(unitStart, scarcityBoost * catMul * jitter);
+            unitBuy = mulRound(unitBuy, scarcityBoost * catMul * jitter);
+            if (unitBuy <= unitStart)
+                unitBuy = unitStart + 1;
+
+            // ---- Friendly rounding (unit): >=1g → 5s steps, else 1s ----
+            auto roundTo = [](uint32_t coppers, uint32_t stepC) -> uint32_t
+            {
+                uint32_t r = coppers % stepC;
+                uint32_t down = coppers - r;
+                uint32_t up = down + stepC;
+                return (coppers - down < up - coppers) ? down : up;
+            };
+            uint32_t step = (unitBuy >= 10000u) ? 500u : 100u;
+            unitBuy = roundTo(unitBuy, step);
+            unitStart = std::min<uint32_t>((unitBuy > 0 ? unitBuy - 1 : 0), roundTo(unitStart, step));
+
+            // ---- Vendor/min floors & markup (unit) ----
+            ApplyVendorFloor(item.buyPrice, unitStart, unitBuy, rules.minPriceCopper, rules.vendorMinMarkup);
+
+            // ---- Clamp to recipe-based ceiling for mats (prevents low tiers from ballooning) ----
+            if (parts.stackableMat && parts.recipeUnitCeil > 0)
+            {
+                if (unitBuy > parts.recipeUnitCeil)
+                    unitBuy = parts.recipeUnitCeil;
+                if (unitStart >= unitBuy)
+                    unitStart = (unitBuy > 0 ? unitBuy - 1 : 0);
+            }
+
+            return PricingResult{unitStart, unitBuy};
+        }
+
+    } // namespace Core
+} // namespace ModDynamicAH
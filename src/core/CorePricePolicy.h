@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CorePricing.h"
+
+namespace ModDynamicAH
+{
+    namespace Core
+    {
+
+        // The settings the sell-side price policies read (SellRules adds the planner's own)
+        struct PriceRules
+        {
+            uint32_t minPriceCopper = 10000;
+
+            // categories multipliers
+            double mulDust = 1.00;
+            double mulEssence = 1.25;
+            double mulShard = 2.00;
+            double mulElemental = 3.00;
+            double mulRareRaw = 3.00;
+
+            // scarcity
+            bool scarcityEnabled = true;
+            double scarcityPriceBoostMax = 0.30;
+
+            // vendor
+            double vendorMinMarkup = 0.25;
+        };
+
+        // recipe floor -> effective min price, plus the ceiling applied after rounding
+        struct RecipeBounds
+        {
+            uint32_t minPrice = 0;
+            uint32_t unitCeil = 0;
+            bool stackableMat = false;
+        };
+
+        // The count-independent inputs of a policy price: recipe bounds and the vendor base
+        struct PriceParts
+        {
+            uint32_t vendorBase = 0;     // VendorBase of the item
+            uint32_t minPrice = 0;       // effective min price after the recipe floor
+            uint32_t recipeUnitCeil = 0; // applied after rounding, stackable mats only
+            bool stackableMat = false;
+        };
+
+        RecipeBounds BoundsFor(PriceRules const &rules, Family fam, uint16_t req, uint16_t maxReq, uint32_t stackSize);
+
+        // Only rules.minPriceCopper and the item's facts go in, so the result can be cached per item
+        PriceParts PartsFor(PriceRules const &rules, Family fam, ItemFacts const &item);
+
+        double CategoryMul(PriceRules const &rules, MatCategory cat);
+
+        // -5%..+5%, fixed per (second, item)
+        double Jitter(uint32_t nowSec, uint32_t itemId);
+
+        // Raises both prices to the min price or, for vendor-sold items, the vendor price plus markup
+        void ApplyVendorFloor(uint32_t vendorBuyPrice, uint32_t &startBid, uint32_t &buyout,
+                              uint32_t minPriceCopper, double vendorMinMarkup);
+
+        // Unit prices from the engine price (ComputeUnit / ComputeBatch at `active`): scarcity
+        // boost, category multiplier, jitter, friendly rounding, vendor floor and recipe ceiling.
+        PricingResult ApplyPolicies(PriceRules const &rules, ItemFacts const &item, PriceParts const &parts,
+                                    PricingResult const &engine, uint32_t active, uint32_t nowSec);
+
+    } // namespace Core
+} // namespace ModDynamicAH
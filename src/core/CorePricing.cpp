@@ -0,0 +1,51 @@
+#include "CorePricing.h"
+
+namespace ModDynamicAH
+{
+    namespace Core
+    {
+
+        PricingResult ComputeUnit(uint32_t vendorBase, uint32_t activeInHouse, uint32_t onlineCount, uint32_t minPriceCopper)
+        {
+            PricingResult r;
+
+            // A very basic baseline from vendor SellPrice; avoid zeros
+            uint32_t base = std::max<uint32_t>(minPriceCopper, vendorBase);
+
+            // Gentle scarcity modulation: fewer active -> higher price
+            double scarcity = 1.0 + (activeInHouse == 0 ? 0.25 : (0.25 / double(1 + activeInHouse)));
+
+            // Online scaling (very low online -> softer prices; high -> slightly higher)
+            double pop = 1.0 + std::min(0.30, double(onlineCount) / 500.0 * 0.10);
+
+            uint32_t startBid = uint32_t(double(base) * scarcity * pop);
+            uint32_t buyout = uint32_t(double(startBid) * 1.45);
+
+            r.startBid = std::max<uint32_t>(minPriceCopper, startBid);
+            r.buyout = std::max<uint32_t>(r.startBid + 1, buyout);
+            return r;
+        }
+
+        void ComputeBatch(PricingBatch const &b)
+        {
+            double const pop = 1.0 + std::min(0.30, double(b.onlineCount) / 500.0 * 0.10);
+
+            for (size_t i = 0; i < b.n; ++i)
+            {
+                uint32_t minPrice = b.minPrice[i];
+                uint32_t base = std::max<uint32_t>(minPrice, b.vendorBase[i]);
+
+                // 0.25 / (1 + 0) is exactly the scalar path's active == 0 case, so no branch is needed
+                double scarcity = 1.0 + 0.25 / double(1 + b.active[i]);
+
+                uint32_t startBid = uint32_t(double(base) * scarcity * pop);
+                uint32_t buyout = uint32_t(double(startBid) * 1.45);
+
+                startBid = std::max<uint32_t>(minPrice, startBid);
+                b.outStart[i] = startBid;
+                b.outBuyout[i] = std::max<uint32_t>(startBid + 1, buyout);
+            }
+        }
+
+    } // namespace Core
+} // namespace ModDynamicAH
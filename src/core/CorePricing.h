@@ -0,0 +1,43 @@
+#pragma once
+
+#include "CoreTypes.h"
+
+#include <algorithm>
+
+namespace ModDynamicAH
+{
+    namespace Core
+    {
+
+        struct PricingResult
+        {
+            uint32_t startBid = 0;
+            uint32_t buyout = 0;
+        };
+
+        // Struct-of-arrays input for ComputeBatch; every pointer addresses n entries.
+        struct PricingBatch
+        {
+            size_t n = 0;
+            uint32_t const *vendorBase = nullptr; // VendorBase per item
+            uint32_t const *active = nullptr;     // active auctions of the item in its house
+            uint32_t const *minPrice = nullptr;   // effective min price per item
+            uint32_t onlineCount = 0;             // shared by the whole batch
+            uint32_t *outStart = nullptr;
+            uint32_t *outBuyout = nullptr;
+        };
+
+        // The template-derived part of the baseline
+        inline uint32_t VendorBase(uint32_t sellPrice, uint32_t buyPrice)
+        {
+            return std::max<uint32_t>(sellPrice, buyPrice / 2);
+        }
+
+        // Unit start bid and buyout from the vendor baseline, house supply and population
+        PricingResult ComputeUnit(uint32_t vendorBase, uint32_t activeInHouse, uint32_t onlineCount, uint32_t minPriceCopper);
+
+        // Same results as ComputeUnit for every entry, without per-item branches so the loop vectorizes.
+        void ComputeBatch(PricingBatch const &b);
+
+    } // namespace Core
+} // namespace ModDynamicAH
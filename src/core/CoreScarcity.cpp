@@ -0,0 +1,17 @@
+#include "CoreScarcity.h"
+
+namespace ModDynamicAH
+{
+    namespace Core
+    {
+
+        ScarcityCounts CountAuctions(std::vector<AuctionFacts> const &rows, bool countUnits)
+        {
+            ScarcityCounts counts;
+            for (AuctionFacts const &r : rows)
+                CountAuction(counts, r.house, r.itemId, r.count, countUnits);
+            return counts;
+        }
+
+    } // namespace Core
+} // namespace ModDynamicAH
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "CoreTypes.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace ModDynamicAH
+{
+    namespace Core
+    {
+
+        // Active auctions of one item in one house
+        struct ScarcityTally
+        {
+            uint32_t auctions = 0;
+            uint32_t units = 0; // stacked units (sum of counts); only with countUnits
+        };
+
+        using ScarcityCounts = std::unordered_map<uint64_t, ScarcityTally>; // key = ScarcityKey
+
+        inline uint64_t ScarcityKey(House house, uint32_t itemId)
+        {
+            return (uint64_t(uint8_t(house)) << 32) | itemId;
+        }
+
+        inline void CountAuction(ScarcityCounts &counts, House house, uint32_t itemId, uint32_t units, bool countUnits)
+        {
+            ScarcityTally &t = counts[ScarcityKey(house, itemId)];
+            ++t.auctions;
+            if (countUnits)
+                t.units += units ? units : 1u;
+        }
+
+        // One pass over a snapshot, as the in-memory scarcity rebuild does over the live houses
+        ScarcityCounts CountAuctions(std::vector<AuctionFacts> const &rows, bool countUnits);
+
+        inline uint32_t ActiveCount(ScarcityCounts const &counts, House house, uint32_t itemId)
+        {
+            auto it = counts.find(ScarcityKey(house, itemId));
+            return it != counts.end() ? it->second.auctions : 0;
+        }
+
+    } // namespace Core
+} // namespace ModDynamicAH
@@ -0,0 +1,60 @@
+#include "CoreSelection.h"
+
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+
+namespace ModDynamicAH
+{
+    namespace Core
+    {
+
+        bool SelectionRules::SameFilter(SelectionRules const &o) const
+        {
+            return blockTrashAndCommon == o.blockTrashAndCommon &&
+                   std::equal(std::begin(allowQuality), std::end(allowQuality), std::begin(o.allowQuality)) &&
+                   whitelist == o.whitelist;
+        }
+
+        bool Sellable(SelectionRules const &rules, ItemFacts const &item)
+        {
+            if (item.buyPrice == 0 && item.sellPrice == 0)
+                return false;
+
+            uint32_t q = item.quality;
+            if (rules.blockTrashAndCommon && q <= QualityNormal && !rules.whitelist.count(item.itemId))
+                return false;
+
+            return q < QualityCount && rules.allowQuality[q];
+        }
+
+        std::vector<size_t> SampleIndices(size_t n, size_t k, uint32_t seed)
+        {
+            k = std::min(k, n);
+            std::vector<size_t> out;
+            if (!k)
+                return out;
+
+            std::mt19937 rng(seed);
+            std::unordered_map<size_t, size_t> swapped;
+            swapped.reserve(k * 2);
+            auto slot = [&](size_t i) -> size_t
+            {
+                auto it = swapped.find(i);
+                return it != swapped.end() ? it->second : i;
+            };
+
+            out.reserve(k);
+            for (size_t i = 0; i < k; ++i)
+            {
+                size_t j = std::uniform_int_distribution<size_t>(i, n - 1)(rng);
+                size_t vi = slot(i);
+                size_t vj = slot(j);
+                swapped[j] = vi;
+                out.push_back(vj);
+            }
+            return out;
+        }
+
+    } // namespace Core
+} // namespace ModDynamicAH
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "CoreTypes.h"
+
+#include <unordered_set>
+#include <vector>
+
+namespace ModDynamicAH
+{
+    namespace Core
+    {
+
+        // Filter of the random-sellable pool
+        struct SelectionRules
+        {
+            bool blockTrashAndCommon = true;
+            bool allowQuality[QualityCount] = {false, false, true, true, true, false}; // Poor..Legendary
+            std::unordered_set<uint32_t> whitelist;                                    // allow specific itemIds (e.g. white)
+
+            bool SameFilter(SelectionRules const &o) const;
+        };
+
+        // Items with a vendor price signal (Buy or Sell), filtered by quality
+        bool Sellable(SelectionRules const &rules, ItemFacts const &item);
+
+        // k distinct indices from [0, n) drawn by a partial Fisher-Yates over a virtual index
+        // array: only swapped slots are stored, so a draw costs O(k) regardless of n. The same
+        // seed gives the same draw.
+        std::vector<size_t> SampleIndices(size_t n, size_t k, uint32_t seed);
+
+        // House a random sellable is posted to
+        inline House RandomHouseFor(uint32_t itemId)
+        {
+            return Houses[itemId % 3];
+        }
+
+    } // namespace Core
+} // namespace ModDynamicAH
@@ -0,0 +1,323 @@
+#include "CoreSellPlanner.h"
+#include "CoreMaterials.h"
+
+#include <algorithm>
+
+namespace ModDynamicAH
+{
+    namespace Core
+    {
+
+        static uint64_t PlanKey(House house, uint32_t itemId)
+        {
+            return (uint64_t(uint8_t(house)) << 32) | itemId;
+        }
+
+        static constexpr House ContextHouses[2] = {House::Alliance, House::Horde};
+
+        static uint32_t StackSizeFor(SellRules const &rules, Family fam)
+        {
+            switch (fam)
+            {
+            case Family::Cloth:
+                return rules.stCloth;
+            case Family::Herb:
+                return rules.stHerb;
+            case Family::Ore:
+                return rules.stOre;
+            case Family::Bar:
+                return rules.stBar;
+            case Family::Dust:
+                return rules.stDust;
+            case Family::Essence:
+                return rules.stDust; // keep parity with previous behavior
+            case Family::Shard:
+                return 1; // shards single
+            case Family::Leather:
+                return rules.stLeather;
+            case Family::Stone:
+                return rules.stStone;
+            case Family::Meat:
+                return rules.stMeat;
+            case Family::Fish:
+                return rules.stFish;
+            default:
+                return rules.stDefault;
+            }
+        }
+
+        void SellPlanner::ResetTick()
+        {
+            _perTickPlanCap.clear();
+            _primed.clear();
+        }
+
+        uint32_t SellPlanner::ClampToStackable(ItemFacts const *item, uint32_t desired)
+        {
+            uint32_t maxStack = (item && item->stackable > 0) ? item->stackable : 1u;
+            return std::min(desired ? desired : 1u, maxStack);
+        }
+
+        uint32_t SellPlanner::ActiveCount(SellRules const &rules, uint32_t itemId, House house) const
+        {
+            return rules.scarcityEnabled ? _scarcity.ActiveCount(itemId, house) : 0;
+        }
+
+        bool SellPlanner::TryPlanOnce(House house, uint32_t itemId)
+        {
+            uint32_t &cnt = _perTickPlanCap[PlanKey(house, itemId)];
+            ++cnt;
+            return true;
+        }
+
+        PriceParts SellPlanner::CachedParts(SellRules const &rules, Family fam, ItemFacts const &item) const
+        {
+            _priceCache.Sync(_catalog.Generation(), rules.minPriceCopper);
+            if (PriceParts const *cached = _priceCache.Find(item.itemId, fam))
+                return *cached;
+            PriceParts parts = PartsFor(rules, fam, item);
+            _priceCache.Store(item.itemId, fam, parts);
+            return parts;
+        }
+
+        void SellPlanner::PrimePrices(SellRules const &rules, std::vector<PriceKey> const &keys)
+        {
+            uint32_t online = _scarcity.OnlineCount();
+
+            // gather the keys as columns
+            std::vector<uint32_t> active, vendorBase, minPrice, start, buyout;
+            std::vector<PriceParts> parts;
+            std::vector<PriceKey const *> pending;
+            for (PriceKey const &k : keys)
+            {
+                ItemFacts const *item = _catalog.Find(k.itemId);
+                if (!item)
+                    continue;
+                PriceParts p = CachedParts(rules, k.fam, *item);
+                active.push_back(ActiveCount(rules, k.itemId, k.house));
+                vendorBase.push_back(p.vendorBase);
+                minPrice.push_back(p.minPrice);
+                parts.push_back(p);
+                pending.push_back(&k);
+            }
+            if (pending.empty())
+                return;
+
+            start.resize(pending.size());
+            buyout.resize(pending.size());
+            PricingBatch batch;
+            batch.n = pending.size();
+            batch.vendorBase = vendorBase.data();
+            batch.active = active.data();
+            batch.minPrice = minPrice.data();
+            batch.onlineCount = online;
+            batch.outStart = start.data();
+            batch.outBuyout = buyout.data();
+            ComputeBatch(batch);
+
+            for (size_t i = 0; i < pending.size(); ++i)
+                _primed[PlanKey(pending[i]->house, pending[i]->itemId)] =
+                    PrimedPrice{parts[i], PricingResult{start[i], buyout[i]}, pending[i]->fam, active[i], online};
+        }
+
+        void SellPlanner::PriceWithPolicies(SellRules const &rules, Family fam, ItemFacts const &item, House house,
+                                            uint32_t &outStart, uint32_t &outBuy) const
+        {
+            uint32_t active = ActiveCount(rules, item.itemId, house);
+            uint32_t online = _scarcity.OnlineCount();
+
+            // ---- Count-independent inputs (cached across cycles) + engine price at today's counts ----
+            // A batch primed this cycle already holds the engine price unless the counts moved since.
+            PriceParts parts;
+            PricingResult base;
+            auto primed = _primed.find(PlanKey(house, item.itemId));
+            if (primed != _primed.end() && primed->second.fam == fam && primed->second.active == active &&
+                primed->second.online == online)
+            {
+                parts = primed->second.parts;
+                base = primed->second.price;
+            }
+            else
+            {
+                parts = CachedParts(rules, fam, item);
+                base = ComputeUnit(parts.vendorBase, active, online, parts.minPrice);
+            }
+
+            PricingResult unit = ApplyPolicies(rules, item, parts, base, active, _nowSec);
+            outStart = unit.startBid;
+            outBuy = unit.buyout;
+            if (_observer)
+                _observer->Priced(fam, house, item.itemId, active, unit);
+        }
+
+        std::vector<uint32_t> const &SellPlanner::Pool(SelectionRules const &rules)
+        {
+            uint32_t gen = _catalog.Generation();
+            if (_poolGen == gen && _poolRules.SameFilter(rules))
+                return _pool;
+
+            // ForEach walks ascending ids, so a given seed samples the same items on every host
+            _pool.clear();
+            _catalog.ForEach([&](ItemFacts const &item)
+                             {
+                                 if (Sellable(rules, item))
+                                     _pool.push_back(item.itemId);
+                             });
+            _poolRules = rules;
+            _poolGen = gen;
+            return _pool;
+        }
+
+        void SellPlanner::BuildRandomPlan(SellRules const &rules)
+        {
+            BeginRandomPlan(rules);
+            StepRandomPlan(rules, TickBudget::Unlimited());
+        }
+
+        void SellPlanner::BeginRandomPlan(SellRules const &rules)
+        {
+            _rndCands.clear();
+            _rndNext = 0;
+            _nowSec = _clock.NowSec();
+
+            if (!rules.enableSeller)
+                return;
+
+            std::vector<uint32_t> const &pool = Pool(rules);
+            for (size_t i : SampleIndices(pool.size(), rules.maxRandomPerCycle, _nowSec))
+                _rndCands.push_back(pool[i]);
+
+            std::vector<PriceKey> keys;
+            keys.reserve(_rndCands.size());
+            for (uint32_t itemId : _rndCands)
+                keys.push_back(PriceKey{Family::Other, itemId, RandomHouseFor(itemId)});
+            PrimePrices(rules, keys);
+        }
+
+        bool SellPlanner::StepRandomPlan(SellRules const &rules, TickBudget const &budget)
+        {
+            while (_rndNext < _rndCands.size())
+            {
+                uint32_t itemId = _rndCands[_rndNext++];
+                if (ItemFacts const *item = _catalog.Find(itemId))
+                {
+                    House house = RandomHouseFor(itemId);
+
+                    if (TryPlanOnce(house, itemId))
+                    {
+                        PricingResult unit;
+                        PriceWithPolicies(rules, Family::Other, *item, house, unit.startBid, unit.buyout);
+
+                        PostDecision d;
+                        d.house = house;
+                        d.itemId = itemId;
+                        d.count = ClampToStackable(item, rules.stDefault);
+                        d.startBid = unit.startBid;
+                        d.buyout = unit.buyout;
+                        d.lane = (rules.scarcityEnabled && _scarcity.ActiveCount(itemId, house) == 0) ? PostLane::Scarce : PostLane::Random;
+                        _sink.Post(d);
+                        if (_observer)
+                            _observer->Planned(PlanReason::Random, *item, d, unit, 1);
+                    }
+                    else
+                        Skip(PlanReason::Capped, itemId);
+                }
+                else
+                    Skip(PlanReason::NoTemplate, itemId);
+
+                if (budget.Exhausted())
+                    break;
+            }
+            return _rndNext >= _rndCands.size();
+        }
+
+        void SellPlanner::EnqueueHouse(SellRules const &rules, House house, Family fam, uint32_t itemId,
+                                       uint32_t desiredStack, uint32_t stacksToPost)
+        {
+            ItemFacts const *item = _catalog.Find(itemId);
+            if (!item)
+            {
+                Skip(PlanReason::NoTemplate, itemId);
+                return;
+            }
+
+            PricingResult unit;
+            PriceWithPolicies(rules, fam, *item, house, unit.startBid, unit.buyout);
+
+            uint32_t count = ClampToStackable(item, desiredStack);
+
+            uint64_t sb = uint64_t(unit.startBid) * count;
+            uint64_t bo = uint64_t(unit.buyout) * count;
+            if (bo <= sb)
+                bo = sb + 1;
+
+            PostDecision d;
+            d.house = house;
+            d.itemId = itemId;
+            d.count = count;
+            d.startBid = sb > UINT32_MAX ? UINT32_MAX : uint32_t(sb);
+            d.buyout = bo > UINT32_MAX ? UINT32_MAX : uint32_t(bo);
+            d.lane = (rules.scarcityEnabled && _scarcity.ActiveCount(itemId, house) == 0) ? PostLane::Scarce : PostLane::Context;
+
+            uint32_t planned = 0;
+            for (; planned < stacksToPost; ++planned)
+            {
+                if (!TryPlanOnce(house, itemId))
+                    break;
+                _sink.Post(d);
+            }
+
+            if (!planned)
+                Skip(PlanReason::Capped, itemId);
+            else if (_observer)
+                _observer->Planned(PlanReason::Context, *item, d, unit, planned);
+        }
+
+        void SellPlanner::BuildContextPlan(SellRules const &rules)
+        {
+            BeginContextPlan(rules);
+            StepContextPlan(rules, TickBudget::Unlimited());
+        }
+
+        void SellPlanner::BeginContextPlan(SellRules const &rules)
+        {
+            _ctxNext = 0;
+            _ctxCount = 0;
+            _nowSec = _clock.NowSec();
+            _primed.clear(); // engine prices are only reused within the cycle that batched them
+
+            if (!rules.contextEnabled)
+                return;
+
+            // Global, once-per-cycle: enqueue every material from all tables exactly once per faction
+            // house. The deduplicated sweep list is built at compile time (CONTEXT_MATS).
+            _ctxCount = CONTEXT_MATS.size();
+
+            // price the whole sweep in one batch; the Step calls then reuse those engine prices
+            std::vector<PriceKey> keys;
+            keys.reserve(CONTEXT_MATS.size() * 2);
+            for (MatInfo const &m : CONTEXT_MATS)
+                for (House h : ContextHouses)
+                    keys.push_back(PriceKey{m.family, m.itemId, h});
+            PrimePrices(rules, keys);
+        }
+
+        bool SellPlanner::StepContextPlan(SellRules const &rules, TickBudget const &budget)
+        {
+            const uint32_t stacksToPost = rules.stacksMid;
+
+            while (_ctxNext < _ctxCount)
+            {
+                MatInfo const &m = CONTEXT_MATS[_ctxNext++];
+                uint32_t desiredStack = StackSizeFor(rules, m.family);
+                for (House h : ContextHouses)
+                    EnqueueHouse(rules, h, m.family, m.itemId, desiredStack, stacksToPost);
+
+                if (budget.Exhausted())
+                    break;
+            }
+            return _ctxNext >= _ctxCount;
+        }
+
+    } // namespace Core
+} // namespace ModDynamicAH
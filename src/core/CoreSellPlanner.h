@@ -0,0 +1,161 @@
+#pragma once
+
+#include "CoreBudget.h"
+#include "CoreInterfaces.h"
+#include "CorePriceCache.h"
+#include "CorePricePolicy.h"
+#include "CoreSelection.h"
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+namespace ModDynamicAH
+{
+    namespace Core
+    {
+
+        // The settings the sell planner reads (PlannerConfig adds the module's own on top)
+        struct SellRules : PriceRules, SelectionRules
+        {
+            bool enableSeller = true;
+
+            // stacks
+            uint32_t stDefault = 20, stCloth = 20, stOre = 20, stBar = 20, stHerb = 20, stLeather = 20, stDust = 20, stGem = 20, stStone = 20, stMeat = 20, stBandage = 20, stPotion = 5, stInk = 10, stPigment = 20, stFish = 20;
+            uint32_t stacksLow = 2, stacksMid = 3, stacksHigh = 2;
+
+            // context planner
+            bool contextEnabled = true;
+
+            // random selection (pool filter in SelectionRules)
+            uint32_t maxRandomPerCycle = 50;
+        };
+
+        enum class PlanReason : uint8_t
+        {
+            Context,    // material planned for a house
+            Random,     // random sellable planned
+            Capped,     // per-item tick cap refused it
+            NoTemplate,
+            COUNT
+        };
+
+        inline constexpr std::array<char const *, size_t(PlanReason::COUNT)> PlanReasonNames = {
+            "context", "random", "capped", "no-template"};
+
+        // One (item, house) to price, as PriceWithPolicies would be called for it
+        struct PriceKey
+        {
+            Family fam;
+            uint32_t itemId;
+            House house;
+        };
+
+        // What the planner priced and planned, for hosts that trace or log it
+        class ISellObserver
+        {
+        public:
+            virtual ~ISellObserver() = default;
+
+            // Every PriceWithPolicies result (unit prices)
+            virtual void Priced(Family fam, House house, uint32_t itemId, uint32_t active, PricingResult const &unit) = 0;
+            // `stacks` posts of `post` went to the sink
+            virtual void Planned(PlanReason reason, ItemFacts const &item, PostDecision const &post,
+                                 PricingResult const &unit, uint32_t stacks) = 0;
+            // Nothing planned for the item (Capped, NoTemplate)
+            virtual void Skipped(PlanReason reason, uint32_t itemId) = 0;
+        };
+
+        // Sell side of a cycle: prices the profession materials (context plan) and a random sample
+        // of sellables (random plan) and hands each post to the sink. Items come from the catalog,
+        // active counts from the scarcity source; the clock is read once per Begin* and seeds the
+        // sample and the price jitter.
+        class SellPlanner
+        {
+        public:
+            SellPlanner(IItemCatalog const &catalog, IScarcitySource const &scarcity, IClock const &clock,
+                        IPersistenceSink &sink)
+                : _catalog(catalog), _scarcity(scarcity), _clock(clock), _sink(sink)
+            {
+            }
+            SellPlanner(SellPlanner const &) = delete;
+            SellPlanner &operator=(SellPlanner const &) = delete;
+
+            void SetObserver(ISellObserver *observer) { _observer = observer; }
+
+            // Forgets the per-item plan counts and the primed prices
+            void ResetTick();
+
+            void BuildContextPlan(SellRules const &rules);
+            void BuildRandomPlan(SellRules const &rules);
+
+            // resumable variants: Begin* prepares the work list, Step* returns true once it is exhausted
+            void BeginContextPlan(SellRules const &rules);
+            bool StepContextPlan(SellRules const &rules, TickBudget const &budget);
+            void BeginRandomPlan(SellRules const &rules);
+            bool StepRandomPlan(SellRules const &rules, TickBudget const &budget);
+
+            // Unit start bid and buyout of `item` in `house` at the current counts
+            void PriceWithPolicies(SellRules const &rules, Family fam, ItemFacts const &item, House house,
+                                   uint32_t &outStart, uint32_t &outBuy) const;
+            // Prices every key with one ComputeBatch call at the current scarcity and online counts;
+            // the PriceWithPolicies calls that follow in the same cycle reuse those engine prices
+            // while the counts are unchanged.
+            void PrimePrices(SellRules const &rules, std::vector<PriceKey> const &keys);
+
+            // Sellable item ids (ascending) under the filter; rebuilt only when the filter or the
+            // catalog generation changes
+            std::vector<uint32_t> const &Pool(SelectionRules const &rules);
+
+            static uint32_t ClampToStackable(ItemFacts const *item, uint32_t desired);
+            PriceCacheStats PriceStats() const { return _priceCache.Stats(); }
+
+        private:
+            // PartsFor through the price cache
+            PriceParts CachedParts(SellRules const &rules, Family fam, ItemFacts const &item) const;
+            uint32_t ActiveCount(SellRules const &rules, uint32_t itemId, House house) const;
+            bool TryPlanOnce(House house, uint32_t itemId);
+            void EnqueueHouse(SellRules const &rules, House house, Family fam, uint32_t itemId,
+                              uint32_t desiredStack, uint32_t stacksToPost);
+            void Skip(PlanReason reason, uint32_t itemId)
+            {
+                if (_observer)
+                    _observer->Skipped(reason, itemId);
+            }
+
+            IItemCatalog const &_catalog;
+            IScarcitySource const &_scarcity;
+            IClock const &_clock;
+            IPersistenceSink &_sink;
+            ISellObserver *_observer = nullptr;
+
+            uint32_t _nowSec = 0; // clock reading of the last Begin*
+            std::unordered_map<uint64_t, uint32_t> _perTickPlanCap; // (house<<32)|itemId -> count this tick
+
+            // in-flight cycle work lists (see Begin*/Step*)
+            size_t _ctxCount = 0; // CONTEXT_MATS entries to sweep this cycle (0 when disabled)
+            size_t _ctxNext = 0;
+            std::vector<uint32_t> _rndCands;
+            size_t _rndNext = 0;
+
+            // sellable pool and the filter + catalog generation it was built for
+            std::vector<uint32_t> _pool;
+            SelectionRules _poolRules;
+            uint32_t _poolGen = 0; // 0 = never built
+
+            mutable PriceCache _priceCache; // survives cycles; see PriceCache for invalidation
+
+            // Engine prices from the last PrimePrices batches of this cycle, with the counts they used
+            struct PrimedPrice
+            {
+                PriceParts parts;
+                PricingResult price;
+                Family fam = Family::Other;
+                uint32_t active = 0;
+                uint32_t online = 0;
+            };
+            std::unordered_map<uint64_t, PrimedPrice> _primed; // (house<<32)|itemId
+        };
+
+    } // namespace Core
+} // namespace ModDynamicAH
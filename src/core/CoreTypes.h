@@ -0,0 +1,102 @@
+#pragma once
+
+// Plain data shared by the core decision code and its hosts. Nothing in src/core includes an
+// AzerothCore header: the worldserver adapts its own types to these (DynamicAHCoreAdapters.h)
+// and tools/ drives the same code from stubs on a plain Linux build.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ModDynamicAH
+{
+    namespace Core
+    {
+
+        // Same values as AuctionHouseId, so hosts convert with a static_cast
+        enum class House : uint8_t
+        {
+            Alliance = 2,
+            Horde = 6,
+            Neutral = 7,
+        };
+
+        inline constexpr House Houses[3] = {House::Alliance, House::Horde, House::Neutral};
+
+        inline constexpr size_t HouseIndex(House h)
+        {
+            return h == House::Alliance ? 0 : h == House::Horde ? 1
+                                                                : 2;
+        }
+
+        // The few ItemTemplate enum values the rules look at
+        inline constexpr uint8_t QualityNormal = 1;       // ITEM_QUALITY_NORMAL
+        inline constexpr uint8_t QualityCount = 6;        // Poor..Legendary
+        inline constexpr uint8_t ItemClassTradeGoods = 7; // ITEM_CLASS_TRADE_GOODS
+
+        // Crafting family of a material (ProfessionMats.h tables); Other for everything else
+        enum class Family : uint8_t
+        {
+            Herb,
+            Ore,
+            Bar,
+            Cloth,
+            Leather,
+            Jewelcrafting,
+            Dust,
+            Essence,
+            Shard,
+            Elemental,
+            Stone,
+            Meat,
+            Fish,
+            Gem,
+            Bandage,
+            Potion,
+            Ink,
+            Pigment,
+            Other,
+            COUNT
+        };
+
+        // Pricing category of a profession material; selects one of the category multipliers.
+        enum class MatCategory : uint8_t
+        {
+            None,
+            Essence,
+            Shard,
+            Elemental,
+            RareRaw,
+        };
+
+        // What the rules need from an item template
+        struct ItemFacts
+        {
+            uint32_t itemId = 0;
+            uint8_t quality = 0;
+            uint8_t itemClass = 0;
+            uint16_t stackable = 1;
+            uint32_t sellPrice = 0;
+            uint32_t buyPrice = 0;
+
+            // joined in from the profession index and the material tables (0 / None when the
+            // item is no reagent)
+            uint16_t recipeEff = 0; // effective recipe skill
+            uint16_t recipeMax = 0; // highest recipe skill
+            MatCategory category = MatCategory::None;
+        };
+
+        // What the rules need from one auction (AuctionRow without the host types)
+        struct AuctionFacts
+        {
+            uint32_t id = 0;
+            House house = House::Neutral;
+            uint32_t itemId = 0;
+            uint32_t count = 1;
+            uint32_t startBid = 0;
+            uint32_t buyout = 0; // whole stack
+            uint32_t owner = 0;  // owner character guid (low part)
+            bool hasBidder = false;
+        };
+
+    } // namespace Core
+} // namespace ModDynamicAH
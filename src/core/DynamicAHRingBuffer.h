@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace ModDynamicAH
+{
+
+    // Growable FIFO ring (single thread). Capacity doubles when full, so Push and Pop are
+    // O(1) amortized and popping never shifts the remaining elements.
+    template <typename T>
+    class RingBuffer
+    {
+    public:
+        void Push(T v)
+        {
+            if (_size == _cap)
+                Grow();
+            _buf[(_head + _size) & (_cap - 1)] = std::move(v);
+            ++_size;
+        }
+
+        // Moves up to n elements into out; returns how many were moved.
+        size_t PopInto(T *out, size_t n)
+        {
+            size_t take = n < _size ? n : _size;
+            for (size_t i = 0; i < take; ++i)
+                out[i] = std::move(_buf[(_head + i) & (_cap - 1)]);
+            _head = (_head + take) & (_cap ? _cap - 1 : 0);
+            _size -= take;
+            return take;
+        }
+
+        size_t Size() const { return _size; }
+        bool Empty() const { return _size == 0; }
+        void Clear()
+        {
+            _head = 0;
+            _size = 0;
+        }
+
+    private:
+        void Grow()
+        {
+            size_t cap = _cap ? _cap * 2 : 64;
+            std::unique_ptr<T[]> buf(new T[cap]);
+            for (size_t i = 0; i < _size; ++i)
+                buf[i] = std::move(_buf[(_head + i) & (_cap - 1)]);
+            _buf = std::move(buf);
+            _cap = cap;
+            _head = 0;
+        }
+
+        std::unique_ptr<T[]> _buf;
+        size_t _cap = 0; // always 0 or a power of two
+        size_t _head = 0;
+        size_t _size = 0;
+    };
+
+} // namespace ModDynamicAH
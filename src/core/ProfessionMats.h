@@ -2,18 +2,39 @@
 // ProfessionMats.h – comprehensive reagent tables for ModDynamicAH
 // Each table is std::array<MatBracket,N> following WotLK trainer breakpoints.
 
+#include <cstddef>
 #include <cstdint>
 #include <initializer_list>
 #include <array>
 
+// Fixed-capacity item list so the tables below are constant-initialized (no static-init code).
+// A bracket listing more than MaxItems ids fails to compile.
+struct MatList
+{
+    static constexpr size_t MaxItems = 6;
+
+    constexpr MatList(std::initializer_list<uint32_t> l) : ids{}, count(0)
+    {
+        for (uint32_t id : l)
+            ids[count++] = id;
+    }
+
+    constexpr uint32_t const *begin() const { return ids; }
+    constexpr uint32_t const *end() const { return ids + count; }
+    constexpr size_t size() const { return count; }
+
+    uint32_t ids[MaxItems];
+    size_t count;
+};
+
 struct MatBracket
 {
     uint16_t minSkill, maxSkill;
-    std::initializer_list<uint32_t> items;
+    MatList items;
 };
 
 // -------------------------------- Cloth / Bandage (Tailoring + First Aid)
-static const std::array<MatBracket, 7> TAILORING_CLOTH = {{
+inline constexpr std::array<MatBracket, 7> TAILORING_CLOTH = {{
     {1, 75, {2589 /* Linen Cloth */}},
     {75, 125, {2592 /* Wool Cloth */}},
     {125, 175, {4306 /* Silk Cloth */}},
@@ -24,7 +45,7 @@ static const std::array<MatBracket, 7> TAILORING_CLOTH = {{
 }};
 
 // -------------------------------- Herbs (Herbalism / Alchemy / Inscription)
-static const std::array<MatBracket, 10> HERBS = {{
+inline constexpr std::array<MatBracket, 10> HERBS = {{
     {1, 70, {765 /* Silverleaf */, 2447 /* Peacebloom */}},
     {70, 115, {2449 /* Earthroot */, 785 /* Mageroyal */, 2450 /* Briarthorn */}},
     {115, 165, {2453 /* Bruiseweed */, 3820 /* Stranglekelp */, 2452 /* Swiftthistle */}},
@@ -38,7 +59,7 @@ static const std::array<MatBracket, 10> HERBS = {{
 }};
 
 // -------------------------------- Mining: Ore (Mining, JC prospecting)
-static const std::array<MatBracket, 9> MINING_ORE = {{
+inline constexpr std::array<MatBracket, 9> MINING_ORE = {{
     {1, 65, {2770 /* Copper Ore */}},
     {65, 125, {2771 /* Tin Ore */}},
     {125, 175, {2772 /* Iron Ore */, 2775 /* Silver Ore */}},
@@ -51,7 +72,7 @@ static const std::array<MatBracket, 9> MINING_ORE = {{
 }};
 
 // -------------------------------- Blacksmithing bars (trainable path)
-static const std::array<MatBracket, 10> BS_BARS = {{
+inline constexpr std::array<MatBracket, 10> BS_BARS = {{
     {1, 75, {2840 /* Copper Bar */}},
     {75, 125, {2841 /* Bronze Bar */, 3576 /* Tin Bar */}},
     {125, 150, {3575 /* Iron Bar */}},
@@ -65,7 +86,7 @@ static const std::array<MatBracket, 10> BS_BARS = {{
 }};
 
 // -------------------------------- Leathers (Skinning / Leatherworking)
-static const std::array<MatBracket, 7> LEATHERS = {{
+inline constexpr std::array<MatBracket, 7> LEATHERS = {{
     {1, 75, {2318 /* Light Leather */}},
     {75, 125, {2319 /* Medium Leather */}},
     {125, 200, {4234 /* Heavy Leather */}},
@@ -76,7 +97,7 @@ static const std::array<MatBracket, 7> LEATHERS = {{
 }};
 
 // -------------------------------- Enchanting dusts
-static const std::array<MatBracket, 7> ENCH_DUSTS = {{
+inline constexpr std::array<MatBracket, 7> ENCH_DUSTS = {{
     {1, 120, {10940 /* Strange Dust */}},
     {120, 180, {11083 /* Soul Dust */}},
     {180, 240, {11137 /* Vision Dust */}},
@@ -87,7 +108,7 @@ static const std::array<MatBracket, 7> ENCH_DUSTS = {{
 }};
 
 // -------------------------------- Stones (Engineering bombs, etc.)
-static const std::array<MatBracket, 5> MINING_STONE = {{
+inline constexpr std::array<MatBracket, 5> MINING_STONE = {{
     {1, 65, {2835 /* Rough Stone */}},
     {65, 125, {2836 /* Coarse Stone */}},
     {125, 175, {2838 /* Heavy Stone */}},
@@ -96,7 +117,7 @@ static const std::array<MatBracket, 5> MINING_STONE = {{
 }};
 
 // -------------------------------- Cooking meats
-static const std::array<MatBracket, 8> COOKING_MEAT = {{
+inline constexpr std::array<MatBracket, 8> COOKING_MEAT = {{
     {1, 60, {769 /* Chunk of Boar Meat */, 2672 /* Stringy Wolf Meat */}},
     {60, 120, {3173 /* Bear Meat */, 3667 /* Tender Crocolisk Meat */}},
     {120, 180, {3730 /* Big Bear Meat */, 3731 /* Lion Meat */}},
@@ -108,7 +129,7 @@ static const std::array<MatBracket, 8> COOKING_MEAT = {{
 }};
 
 // -------------------------------- Fishing / raw fish
-static const std::array<MatBracket, 8> FISHING_RAW = {{
+inline constexpr std::array<MatBracket, 8> FISHING_RAW = {{
     {1, 75, {6289 /* Raw Longjaw Mud Snapper */, 6291 /* Raw Brilliant Smallfish */}},
     {75, 150, {6308 /* Raw Bristle Whisker Catfish */, 6362 /* Raw Rockscale Cod */}},
     {150, 225, {6359 /* Firefin Snapper */, 6361 /* Raw Rainbow Fin Albacore */}},
@@ -120,7 +141,7 @@ static const std::array<MatBracket, 8> FISHING_RAW = {{
 }};
 
 // -------------------------------- JC prospect gems
-static const std::array<MatBracket, 6> JEWELCRAFT_GEMS = {{
+inline constexpr std::array<MatBracket, 6> JEWELCRAFT_GEMS = {{
     {1, 180, {774 /* Malachite */, 818 /* Tigerseye */, 1210 /* Shadowgem */, 1206 /* Moss Agate */}},
     {180, 230, {1705 /* Lesser Moonstone */, 1529 /* Jade */}},
     {230, 300, {7910 /* Star Ruby */, 7909 /* Aquamarine */, 3864 /* Citrine */}},
@@ -130,7 +151,7 @@ static const std::array<MatBracket, 6> JEWELCRAFT_GEMS = {{
 }};
 
 // -------------------------------- Enchanting essences
-static const std::array<MatBracket, 7> ENCH_ESSENCE = {{
+inline constexpr std::array<MatBracket, 7> ENCH_ESSENCE = {{
     {1, 70, {10938 /* Lesser Magic Essence */}},
     {70, 150, {10998 /* Lesser Astral Essence */}},
     {150, 225, {11134 /* Lesser Mystic Essence */, 11174 /* Lesser Nether Essence */}},
@@ -141,7 +162,7 @@ static const std::array<MatBracket, 7> ENCH_ESSENCE = {{
 }};
 
 // -------------------------------- Enchanting shards + rods
-static const std::array<MatBracket, 6> ENCH_SHARDS = {{
+inline constexpr std::array<MatBracket, 6> ENCH_SHARDS = {{
     {1, 150, {10978 /* Small Glimmering Shard */, 10998 /* Lesser Astral Essence */, 6218 /* Runed Copper Rod */, 6339 /* Runed Silver Rod */}},
     {150, 225, {11138 /* Small Glowing Shard */, 11139 /* Large Glowing Shard */, 11130 /* Runed Golden Rod */, 11145 /* Runed Truesilver Rod */}},
     {225, 285, {11174 /* Lesser Nether Shard */, 11175 /* Large Nether Shard */, 22461 /* Runed Fel Iron Rod */}},
@@ -151,7 +172,7 @@ static const std::array<MatBracket, 6> ENCH_SHARDS = {{
 }};
 
 // -------------------------------- Elementals / Primals / Eternals
-static const std::array<MatBracket, 4> ELEMENTALS = {{
+inline constexpr std::array<MatBracket, 4> ELEMENTALS = {{
     {300, 330, {22451 /* Primal Air */, 22452 /* Primal Earth */, 22456 /* Primal Shadow */}},
     {330, 375, {22457 /* Primal Mana */, 21884 /* Primal Fire */, 21885 /* Primal Water */}},
     {375, 425, {37701 /* Crystallized Earth */, 37702 /* Crystallized Fire */, 37703 /* Crystallized Shadow */}},
@@ -159,7 +180,7 @@ static const std::array<MatBracket, 4> ELEMENTALS = {{
 }};
 
 // -------------------------------- Rare raws / special mats
-static const std::array<MatBracket, 4> RARE_RAW = {{
+inline constexpr std::array<MatBracket, 4> RARE_RAW = {{
     {250, 310, {12655 /* Enchanted Thorium Bar */}},
     {330, 375, {23571 /* Primal Might */, 25707 /* Fel Hide */}},
     {375, 450, {33568 /* Borean Leather */, 43007 /* Northern Spices */, 45087 /* Runed Orb */}},
@@ -4,6 +4,7 @@
 void AddDynamicAhScripts()
 {
     new ModDynamicAH::DynamicAHWorld();
+    new ModDynamicAH::DynamicAHAuctionHooks();
     new DynamicAHCommands();
 }
 
@@ -0,0 +1,464 @@
+// dah_bench: times the decision code in src/core on synthetic in-memory data and writes the
+// results as JSON, so runs can be compared across commits on the same machine. Each result's
+// "covers" names the code its timed region runs. The sell.* and buy.* cases time the core planner
+// entry points that DynamicAHPlanner (PriceWithPolicies, BuildContextPlan, BuildRandomPlan) and
+// BuyEngine (BuildPlan) run, with the stubs in place of the item index and the live auction houses.
+//
+//   dah_bench [--sizes 1000,10000,100000] [--reps 7] [--seed 1] [--filter name] [--out file]
+//
+// Every case runs `reps` times per size after one untimed warm-up; each rep rebuilds its input
+// outside the timed region. Reported times are per rep; ns_per_op divides the median by the
+// number of elements the case processes (items, priced keys, posts, rows or queue entries).
+
+#include "CoreBuyPlanner.h"
+#include "CoreMaterials.h"
+#include "CorePostQueue.h"
+#include "CorePricing.h"
+#include "CoreSellPlanner.h"
+#include "StubCore.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef DAH_GIT_REV
+#define DAH_GIT_REV "unknown"
+#endif
+#ifndef DAH_BUILD_TYPE
+#define DAH_BUILD_TYPE "unknown"
+#endif
+
+using namespace ModDynamicAH;
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Keeps results observable so the optimizer cannot drop the measured work
+    volatile uint64_t g_sink = 0;
+
+    uint64_t NsSince(Clock::time_point t0)
+    {
+        return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count());
+    }
+
+    struct Options
+    {
+        std::vector<size_t> sizes = {1000, 10000, 100000};
+        uint32_t reps = 7;
+        uint32_t seed = 1;
+        std::string filter;
+        std::string out;
+    };
+
+    // --- synthetic data -------------------------------------------------------------------------
+
+    // Items 1..n with vendor prices and a quality mix close to a 3.3.5 template store
+    std::vector<Core::ItemFacts> MakeItems(size_t n, uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        std::discrete_distribution<int> quality({12, 38, 30, 14, 5, 1});
+        std::uniform_int_distribution<uint32_t> price(1, 250000);
+        std::uniform_int_distribution<int> pct(0, 99);
+
+        std::vector<Core::ItemFacts> items(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            Core::ItemFacts &f = items[i];
+            f.itemId = uint32_t(i + 1);
+            f.quality = uint8_t(quality(rng));
+            f.itemClass = pct(rng) < 15 ? Core::ItemClassTradeGoods : uint8_t(pct(rng) % 16);
+            f.stackable = f.itemClass == Core::ItemClassTradeGoods ? 20 : 1;
+            f.sellPrice = pct(rng) < 10 ? 0 : price(rng);
+            f.buyPrice = pct(rng) < 40 ? f.sellPrice * 4 : 0;
+        }
+        return items;
+    }
+
+    // n auctions over `items`, split evenly across the houses, buyouts spread around vendor value
+    std::vector<Core::AuctionFacts> MakeAuctions(size_t n, std::vector<Core::ItemFacts> const &items, uint32_t seed)
+    {
+        std::mt19937 rng(seed ^ 0x9e3779b9u);
+        std::uniform_int_distribution<size_t> pick(0, items.size() - 1);
+        std::uniform_real_distribution<double> spread(0.2, 6.0);
+        std::uniform_int_distribution<uint32_t> owner(1, 2000);
+        std::uniform_int_distribution<int> pct(0, 99);
+
+        std::vector<Core::AuctionFacts> rows(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            Core::ItemFacts const &it = items[pick(rng)];
+            Core::AuctionFacts &r = rows[i];
+            r.id = uint32_t(i + 1);
+            r.house = Core::Houses[i % 3];
+            r.itemId = it.itemId;
+            r.count = 1 + uint32_t(rng() % it.stackable);
+            uint32_t unit = std::max<uint32_t>(1, uint32_t(Core::VendorBase(it.sellPrice, it.buyPrice) * spread(rng)));
+            r.buyout = pct(rng) < 8 ? 0 : unit * r.count;
+            r.startBid = r.buyout ? r.buyout * 3 / 4 : unit * r.count;
+            r.owner = owner(rng);
+            r.hasBidder = pct(rng) < 5;
+        }
+        return rows;
+    }
+
+    // Sell planner over items 1..n plus the context materials (as reagents of mid-tier recipes),
+    // active counts from n auctions, 120 online
+    struct SellBench
+    {
+        Stub::VectorItemCatalog catalog;
+        Stub::CountedScarcity scarcity;
+        Stub::ManualClock clock;
+        Stub::RecordingSink sink;
+        Core::SellPlanner planner{catalog, scarcity, clock, sink};
+        Core::SellRules rules;
+
+        SellBench(size_t n, uint32_t seed) : clock(uint64_t(seed) * 1000)
+        {
+            std::vector<Core::ItemFacts> items = MakeItems(n, seed);
+            scarcity.Recount(MakeAuctions(n, items, seed));
+            scarcity.SetOnlineCount(120);
+            for (Core::ItemFacts const &item : items)
+                catalog.Put(item);
+            for (Core::MatInfo const &m : Core::CONTEXT_MATS)
+            {
+                Core::ItemFacts f;
+                f.itemId = m.itemId;
+                f.quality = 1;
+                f.itemClass = Core::ItemClassTradeGoods;
+                f.stackable = 20;
+                f.sellPrice = 400;
+                f.recipeEff = 150;
+                f.recipeMax = 300;
+                f.category = m.category;
+                catalog.Put(f);
+            }
+        }
+    };
+
+    Core::BuyScanRules BuyRules(size_t n)
+    {
+        Core::BuyScanRules rules;
+        rules.enabled = true;
+        rules.maxScanRows = uint32_t(n); // every row
+        rules.budgetCopper = UINT64_MAX / 2;
+        rules.perItemPerCycleCap = 2;
+        rules.ownerAlliance = 1;
+        rules.ownerHorde = 2;
+        rules.ownerNeutral = 3;
+        return rules;
+    }
+
+    // Mirrors PostRequest without the worldserver types
+    struct BenchPost
+    {
+        Core::House house = Core::House::Neutral;
+        uint32_t itemId = 0;
+        uint32_t count = 1;
+        uint32_t startBid = 0;
+        uint32_t buyout = 0;
+        uint32_t duration = 12 * 3600;
+        Core::PostLane lane = Core::PostLane::Context;
+    };
+
+    // --- cases ------------------------------------------------------------------------------------
+
+    struct Case
+    {
+        char const *name;
+        char const *covers; // the code the timed region runs, and nothing else
+        std::function<uint64_t(size_t n, uint32_t seed)> run; // one timed rep; returns ns
+        size_t (*ops)(size_t n) = nullptr; // elements one rep processes; n when null
+    };
+
+    std::vector<Case> Cases()
+    {
+        std::vector<Case> cases;
+
+        cases.push_back({"pricing.compute", "Core::ComputeUnit", [](size_t n, uint32_t seed)
+                         {
+                             auto items = MakeItems(n, seed);
+                             uint64_t acc = 0;
+                             auto t0 = Clock::now();
+                             for (size_t i = 0; i < n; ++i)
+                             {
+                                 Core::PricingResult p = Core::ComputeUnit(
+                                     Core::VendorBase(items[i].sellPrice, items[i].buyPrice), uint32_t(i % 40), 120, 10000);
+                                 acc += p.buyout;
+                             }
+                             uint64_t ns = NsSince(t0);
+                             g_sink = g_sink + acc;
+                             return ns;
+                         }});
+
+        cases.push_back({"pricing.batch", "Core::ComputeBatch", [](size_t n, uint32_t seed)
+                         {
+                             auto items = MakeItems(n, seed);
+                             std::vector<uint32_t> base(n), active(n), minPrice(n, 10000), start(n), buyout(n);
+                             for (size_t i = 0; i < n; ++i)
+                             {
+                                 base[i] = Core::VendorBase(items[i].sellPrice, items[i].buyPrice);
+                                 active[i] = uint32_t(i % 40);
+                             }
+                             Core::PricingBatch b;
+                             b.n = n;
+                             b.vendorBase = base.data();
+                             b.active = active.data();
+                             b.minPrice = minPrice.data();
+                             b.onlineCount = 120;
+                             b.outStart = start.data();
+                             b.outBuyout = buyout.data();
+                             auto t0 = Clock::now();
+                             Core::ComputeBatch(b);
+                             uint64_t ns = NsSince(t0);
+                             g_sink = g_sink + buyout[n / 2];
+                             return ns;
+                         }});
+
+        // The price cache is warmed by an untimed pass first, as it is from the second cycle on
+        cases.push_back({"sell.price_with_policies", "Core::SellPlanner::PriceWithPolicies (DynamicAHPlanner::PriceWithPolicies)",
+                         [](size_t n, uint32_t seed)
+                         {
+                             SellBench b(n, seed);
+                             Core::SellRules noDraw = b.rules;
+                             noDraw.enableSeller = false;
+                             b.planner.BeginRandomPlan(noDraw); // only reads the clock: nothing drawn or primed
+                             auto priceAll = [&]()
+                             {
+                                 uint64_t acc = 0;
+                                 for (uint32_t id = 1; id <= n; ++id)
+                                 {
+                                     uint32_t start = 0, buy = 0;
+                                     b.planner.PriceWithPolicies(b.rules, Core::Family::Other, *b.catalog.Find(id),
+                                                                 Core::RandomHouseFor(id), start, buy);
+                                     acc += buy;
+                                 }
+                                 return acc;
+                             };
+                             priceAll();
+                             auto t0 = Clock::now();
+                             uint64_t acc = priceAll();
+                             uint64_t ns = NsSince(t0);
+                             g_sink = g_sink + acc;
+                             return ns;
+                         }});
+
+        // Batch-primes and posts every context material in both faction houses; the work does not
+        // grow with n (only the catalog and scarcity maps the lookups go through do)
+        cases.push_back({"sell.build_context_plan", "Core::SellPlanner::BuildContextPlan (DynamicAHPlanner::BuildContextPlan)",
+                         [](size_t n, uint32_t seed)
+                         {
+                             SellBench b(n, seed);
+                             b.sink.posts.reserve(Core::CONTEXT_MATS.size() * 2 * b.rules.stacksMid);
+                             auto t0 = Clock::now();
+                             b.planner.BuildContextPlan(b.rules);
+                             uint64_t ns = NsSince(t0);
+                             g_sink = g_sink + b.sink.posts.size();
+                             return ns;
+                         },
+                         [](size_t) { return Core::CONTEXT_MATS.size() * 2; }});
+
+        // Draws and posts n/10 sellables; the pool is built untimed, as the reload warm-up does
+        cases.push_back({"sell.build_random_plan", "Core::SellPlanner::BuildRandomPlan (DynamicAHPlanner::BuildRandomPlan)",
+                         [](size_t n, uint32_t seed)
+                         {
+                             SellBench b(n, seed);
+                             b.rules.maxRandomPerCycle = uint32_t(std::max<size_t>(1, n / 10));
+                             b.planner.Pool(b.rules);
+                             b.sink.posts.reserve(b.rules.maxRandomPerCycle);
+                             auto t0 = Clock::now();
+                             b.planner.BuildRandomPlan(b.rules);
+                             uint64_t ns = NsSince(t0);
+                             g_sink = g_sink + b.sink.posts.size();
+                             return ns;
+                         },
+                         [](size_t n) { return std::max<size_t>(1, n / 10); }});
+
+        // Scans n rows over a 20k-item catalog: row filters, memoized fair price, DecideBuy. Rows
+        // come from the stub source in ScanHouse chunks (the live source walks sAuctionMgr's maps).
+        cases.push_back({"buy.build_plan", "Core::BuyPlanner::BuildPlan (BuyEngine::BuildPlan)", [](size_t n, uint32_t seed)
+                         {
+                             auto items = MakeItems(20000, seed);
+                             std::vector<Core::AuctionFacts> rows = MakeAuctions(n, items, seed);
+                             Stub::VectorAuctionSource auctions;
+                             for (Core::AuctionFacts const &r : rows)
+                                 auctions.Add(r);
+                             auctions.Index();
+                             Stub::VectorItemCatalog catalog(std::move(items));
+                             Stub::CountedScarcity scarcity;
+                             scarcity.Recount(rows);
+                             Stub::RecordingSink sink;
+                             Core::BuyScanRules rules = BuyRules(n);
+                             Core::BuyPlanner planner(rules, catalog, sink);
+                             Core::DefaultBuyPolicy policy{scarcity, 120, rules.minPriceCopper};
+                             auto t0 = Clock::now();
+                             planner.BuildPlan(auctions, policy);
+                             uint64_t ns = NsSince(t0);
+                             g_sink = g_sink + sink.buys.size();
+                             return ns;
+                         }});
+
+        // n requests spread over the lanes, drained in the service's 64-entry batches
+        cases.push_back({"post_queue.drain", "Core::LaneQueue::DrainInto", [](size_t n, uint32_t seed)
+                         {
+                             Core::LaneQueue<BenchPost> q;
+                             std::mt19937 rng(seed);
+                             for (size_t i = 0; i < n; ++i)
+                             {
+                                 BenchPost p;
+                                 p.itemId = uint32_t(i + 1);
+                                 p.lane = Core::PostLane(rng() % uint32_t(Core::PostLane::COUNT));
+                                 q.Push(p);
+                             }
+                             BenchPost buf[64];
+                             uint64_t acc = 0;
+                             auto t0 = Clock::now();
+                             while (uint32_t got = q.DrainInto(buf, 64))
+                                 acc += buf[got - 1].itemId;
+                             uint64_t ns = NsSince(t0);
+                             g_sink = g_sink + acc;
+                             return ns;
+                         }});
+
+        return cases;
+    }
+
+    // --- output -----------------------------------------------------------------------------------
+
+    struct Result
+    {
+        char const *name;
+        char const *covers;
+        size_t size;
+        size_t ops; // elements per rep
+        std::vector<uint64_t> ns; // per rep, sorted
+    };
+
+    std::string JsonEscape(std::string const &s)
+    {
+        std::string out;
+        for (char c : s)
+        {
+            if (c == '"' || c == '\\')
+                out += '\\';
+            if (uint8_t(c) >= 0x20)
+                out += c;
+        }
+        return out;
+    }
+
+    void WriteJson(std::ostream &os, Options const &opt, std::vector<Result> const &results)
+    {
+        auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        char when[32];
+        std::strftime(when, sizeof(when), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+        os << "{\n";
+        os << "  \"tool\": \"dah_bench\",\n";
+        os << "  \"git_rev\": \"" << JsonEscape(DAH_GIT_REV) << "\",\n";
+        os << "  \"build_type\": \"" << JsonEscape(DAH_BUILD_TYPE) << "\",\n";
+        os << "  \"compiler\": \"" << JsonEscape(__VERSION__) << "\",\n";
+        os << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+        os << "  \"timestamp\": \"" << when << "\",\n";
+        os << "  \"reps\": " << opt.reps << ",\n";
+        os << "  \"seed\": " << opt.seed << ",\n";
+        os << "  \"results\": [";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            Result const &r = results[i];
+            uint64_t median = r.ns[r.ns.size() / 2];
+            double perOp = r.ops ? double(median) / double(r.ops) : 0.0;
+            char line[512];
+            std::snprintf(line, sizeof(line),
+                          "%s\n    {\"name\": \"%s\", \"covers\": \"%s\", \"size\": %zu, \"ops\": %zu, \"min_ns\": %llu, "
+                          "\"median_ns\": %llu, \"max_ns\": %llu, \"ns_per_op\": %.3f, \"ops_per_sec\": %.0f}",
+                          i ? "," : "", r.name, r.covers, r.size, r.ops,
+                          (unsigned long long)r.ns.front(), (unsigned long long)median, (unsigned long long)r.ns.back(),
+                          perOp, perOp > 0.0 ? 1e9 / perOp : 0.0);
+            os << line;
+        }
+        os << "\n  ]\n}\n";
+    }
+
+    bool ParseArgs(int argc, char **argv, Options &opt)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string a = argv[i];
+            char const *val = i + 1 < argc ? argv[i + 1] : nullptr;
+            if (a == "--sizes" && val)
+            {
+                opt.sizes.clear();
+                std::stringstream ss(val);
+                std::string tok;
+                while (std::getline(ss, tok, ','))
+                    if (size_t n = std::strtoull(tok.c_str(), nullptr, 10))
+                        opt.sizes.push_back(n);
+                ++i;
+            }
+            else if (a == "--reps" && val)
+                opt.reps = std::max(1u, uint32_t(std::strtoul(argv[++i], nullptr, 10)));
+            else if (a == "--seed" && val)
+                opt.seed = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+            else if (a == "--filter" && val)
+                opt.filter = argv[++i];
+            else if (a == "--out" && val)
+                opt.out = argv[++i];
+            else
+                return false;
+        }
+        return !opt.sizes.empty();
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options opt;
+    if (!ParseArgs(argc, argv, opt))
+    {
+        std::fprintf(stderr, "usage: %s [--sizes N,N,...] [--reps N] [--seed N] [--filter name] [--out file]\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<Result> results;
+    for (Case const &c : Cases())
+    {
+        if (!opt.filter.empty() && std::string(c.name).find(opt.filter) == std::string::npos)
+            continue;
+        for (size_t n : opt.sizes)
+        {
+            Result r{c.name, c.covers, n, c.ops ? c.ops(n) : n, {}};
+            c.run(n, opt.seed); // warm-up
+            for (uint32_t rep = 0; rep < opt.reps; ++rep)
+                r.ns.push_back(c.run(n, opt.seed + rep));
+            std::sort(r.ns.begin(), r.ns.end());
+            std::fprintf(stderr, "%-26s n=%-8zu median %10.3f ms  %8.2f ns/op\n", c.name, n,
+                         double(r.ns[r.ns.size() / 2]) / 1e6, double(r.ns[r.ns.size() / 2]) / double(r.ops));
+            results.push_back(std::move(r));
+        }
+    }
+
+    if (opt.out.empty())
+        WriteJson(std::cout, opt, results);
+    else
+    {
+        std::ofstream f(opt.out);
+        if (!f)
+        {
+            std::fprintf(stderr, "cannot write %s\n", opt.out.c_str());
+            return 1;
+        }
+        WriteJson(f, opt, results);
+    }
+    return 0;
+}
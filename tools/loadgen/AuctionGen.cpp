@@ -0,0 +1,113 @@
+#include "AuctionGen.h"
+#include "CorePricing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace ModDynamicAH
+{
+    namespace Stub
+    {
+
+        namespace
+        {
+            std::vector<Core::ItemFacts> MakeCatalog(LoadProfile const &p, std::mt19937 &rng)
+            {
+                std::discrete_distribution<int> quality(p.qualityWeights.begin(), p.qualityWeights.end());
+                std::bernoulli_distribution tradeGoods(std::clamp(p.tradeGoodsShare, 0.0, 1.0));
+                std::bernoulli_distribution vendorSold(0.4);
+                // vendor sell prices are roughly log-uniform from 1c to 25g
+                std::uniform_real_distribution<double> logPrice(0.0, std::log(250000.0));
+                std::uniform_int_distribution<int> otherClass(0, 15);
+
+                std::vector<Core::ItemFacts> items(p.items);
+                for (uint32_t i = 0; i < p.items; ++i)
+                {
+                    Core::ItemFacts &f = items[i];
+                    f.itemId = i + 1;
+                    f.quality = uint8_t(quality(rng));
+                    if (tradeGoods(rng))
+                    {
+                        f.itemClass = Core::ItemClassTradeGoods;
+                        f.stackable = 20;
+                    }
+                    else
+                    {
+                        int c = otherClass(rng);
+                        f.itemClass = uint8_t(c == Core::ItemClassTradeGoods ? 0 : c);
+                        f.stackable = 1;
+                    }
+                    f.sellPrice = uint32_t(std::exp(logPrice(rng)));
+                    f.buyPrice = vendorSold(rng) ? f.sellPrice * 4 : 0;
+                }
+                return items;
+            }
+
+            // Zipf weights over a shuffled item order, so popularity is not tied to item id
+            std::discrete_distribution<uint32_t> ItemPicker(LoadProfile const &p, std::mt19937 &rng)
+            {
+                std::vector<uint32_t> rank(p.items);
+                for (uint32_t i = 0; i < p.items; ++i)
+                    rank[i] = i;
+                std::shuffle(rank.begin(), rank.end(), rng);
+
+                std::vector<double> w(p.items);
+                for (uint32_t i = 0; i < p.items; ++i)
+                    w[i] = 1.0 / std::pow(double(rank[i]) + 1.0, std::max(0.0, p.itemSkew));
+                return std::discrete_distribution<uint32_t>(w.begin(), w.end());
+            }
+        }
+
+        void GenerateLoad(LoadProfile const &p, VectorItemCatalog &catalog, VectorAuctionSource &auctions)
+        {
+            std::mt19937 rng(p.seed);
+            std::vector<Core::ItemFacts> items = MakeCatalog(p, rng);
+            auctions.Clear();
+            if (items.empty())
+            {
+                catalog = VectorItemCatalog();
+                return;
+            }
+
+            std::discrete_distribution<uint32_t> pickItem = ItemPicker(p, rng);
+            std::discrete_distribution<int> pickHouse(p.houseSplit.begin(), p.houseSplit.end());
+            std::uniform_real_distribution<double> spread(std::min(p.spreadMin, p.spreadMax), std::max(p.spreadMin, p.spreadMax));
+            std::uniform_real_distribution<double> roll(0.0, 1.0);
+            uint32_t firstPlayer = *std::max_element(p.botOwners.begin(), p.botOwners.end()) + 1;
+            std::uniform_int_distribution<uint32_t> player(firstPlayer, firstPlayer + std::max(1u, p.playerOwners) - 1);
+
+            auctions.Reserve(p.auctions);
+            for (uint32_t i = 0; i < p.auctions; ++i)
+            {
+                Core::ItemFacts const &it = items[pickItem(rng)];
+                int h = pickHouse(rng);
+
+                Core::AuctionFacts r;
+                r.id = i + 1;
+                r.house = Core::Houses[h];
+                r.itemId = it.itemId;
+
+                r.count = 1;
+                if (it.stackable > 1)
+                {
+                    uint32_t hi = std::clamp<uint32_t>(p.stackMax, 1, it.stackable);
+                    uint32_t lo = std::clamp<uint32_t>(p.stackMin, 1, hi);
+                    r.count = roll(rng) < p.fullStackShare ? hi : std::uniform_int_distribution<uint32_t>(lo, hi)(rng);
+                }
+
+                double base = std::max(1.0, double(Core::VendorBase(it.sellPrice, it.buyPrice)));
+                uint32_t unit = uint32_t(std::clamp(base * spread(rng), 1.0, double(UINT32_MAX / 20)));
+                r.buyout = roll(rng) < p.noBuyoutShare ? 0 : unit * r.count;
+                r.startBid = std::max<uint32_t>(1, unit * r.count * 3 / 4);
+                r.owner = roll(rng) < p.botShare ? p.botOwners[h] : player(rng);
+                r.hasBidder = roll(rng) < p.bidderShare;
+                auctions.Add(r);
+            }
+
+            catalog = VectorItemCatalog(std::move(items));
+        }
+
+    } // namespace Stub
+} // namespace ModDynamicAH
@@ -0,0 +1,50 @@
+#pragma once
+
+// Seeded synthetic auction houses for scaling runs: fills the stub catalog and auction source
+// with a configurable item mix, stack sizes, price spread and house split. The same profile
+// and seed always produce the same rows.
+
+#include "StubCore.h"
+
+#include <array>
+
+namespace ModDynamicAH
+{
+    namespace Stub
+    {
+
+        struct LoadProfile
+        {
+            uint32_t seed = 1;
+            uint32_t items = 30000;    // distinct item templates in the catalog (ids 1..items)
+            uint32_t auctions = 50000; // rows to generate
+
+            // How often each item is listed: weight of the k-th most listed item ~ 1 / k^itemSkew
+            // (0 = uniform). Live houses sit around 1.0: a few mats and consumables dominate.
+            double itemSkew = 1.0;
+            std::array<double, Core::QualityCount> qualityWeights{12, 38, 30, 14, 5, 1}; // Poor..Legendary
+            double tradeGoodsShare = 0.15; // catalog share of item class 7, which stacks
+
+            // Stack size of a listing: stackables draw uniformly in [stackMin, min(stackMax, 20)],
+            // with fullStackShare of them posted as a full stack; everything else is 1.
+            uint32_t stackMin = 1;
+            uint32_t stackMax = 20;
+            double fullStackShare = 0.35;
+
+            // Unit buyout = vendor baseline x uniform [spreadMin, spreadMax]
+            double spreadMin = 0.3;
+            double spreadMax = 4.0;
+            double noBuyoutShare = 0.08;
+            double bidderShare = 0.05;
+
+            std::array<double, 3> houseSplit{0.4, 0.4, 0.2}; // Alliance, Horde, Neutral
+            double botShare = 0.10;                          // rows owned by the bot characters below
+            std::array<uint32_t, 3> botOwners{1, 2, 3};      // per house, as BuyRules::owner*
+            uint32_t playerOwners = 5000;                    // other owners draw from botOwners.max+1 ..
+        };
+
+        // Replaces the contents of both stubs
+        void GenerateLoad(LoadProfile const &p, VectorItemCatalog &catalog, VectorAuctionSource &auctions);
+
+    } // namespace Stub
+} // namespace ModDynamicAH
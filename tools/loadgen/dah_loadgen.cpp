@@ -0,0 +1,301 @@
+// dah_loadgen: fills the stub auction source with a seeded synthetic house and measures the
+// scarcity counting pass and the buy planner's BuildPlan scan against it, in rows/s and peak
+// resident memory.
+//
+//   dah_loadgen [--auctions 50000,200000,500000] [--items 30000] [--skew 1.0]
+//               [--stack 1-20] [--full-stack 0.35] [--spread 0.3-4.0] [--houses 40,40,20]
+//               [--bots 0.1] [--seed 1] [--reps 3] [--out file]
+//
+// Peak memory is VmHWM from /proc/self/status, reset before each size where the kernel allows
+// it (clear_refs); elsewhere it falls back to getrusage and only ever grows.
+
+#include "AuctionGen.h"
+#include "CoreBuyPlanner.h"
+#include "CoreScarcity.h"
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ModDynamicAH;
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Options
+    {
+        Stub::LoadProfile profile;
+        std::vector<uint32_t> sizes = {50000, 200000, 500000};
+        uint32_t reps = 3;
+        std::string out;
+    };
+
+    double SecondsSince(Clock::time_point t0)
+    {
+        return std::chrono::duration<double>(Clock::now() - t0).count();
+    }
+
+    // Peak resident set in KiB
+    uint64_t PeakRssKb()
+    {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line))
+            if (line.compare(0, 6, "VmHWM:") == 0)
+                return std::strtoull(line.c_str() + 6, nullptr, 10);
+
+        rusage ru{};
+        getrusage(RUSAGE_SELF, &ru);
+        return uint64_t(ru.ru_maxrss);
+    }
+
+    bool ResetPeakRss()
+    {
+        std::ofstream f("/proc/self/clear_refs");
+        return f && (f << "5").good();
+    }
+
+    double Median(std::vector<double> v)
+    {
+        std::sort(v.begin(), v.end());
+        return v[v.size() / 2];
+    }
+
+    struct SizeResult
+    {
+        uint32_t auctions = 0;
+        double genSec = 0;
+        double scarcitySec = 0; // median per rep
+        size_t scarcityKeys = 0;
+        double buySec = 0; // median per rep
+        uint32_t buyScanned = 0;
+        uint32_t buyAccepted = 0;
+        uint64_t baseRssKb = 0; // after generation
+        uint64_t peakRssKb = 0;
+        bool peakReset = false;
+    };
+
+    SizeResult RunSize(Options const &opt, uint32_t auctions)
+    {
+        SizeResult r;
+        r.auctions = auctions;
+        r.peakReset = ResetPeakRss();
+
+        Stub::LoadProfile p = opt.profile;
+        p.auctions = auctions;
+        Stub::VectorItemCatalog catalog;
+        Stub::VectorAuctionSource source;
+        auto t0 = Clock::now();
+        Stub::GenerateLoad(p, catalog, source);
+        r.genSec = SecondsSince(t0);
+        r.baseRssKb = PeakRssKb();
+
+        // Scarcity builder: snapshot + one counting pass, as RebuildFromMemory with CountUnits
+        std::vector<double> times;
+        for (uint32_t rep = 0; rep < opt.reps; ++rep)
+        {
+            t0 = Clock::now();
+            std::vector<Core::AuctionFacts> rows;
+            source.Snapshot(rows);
+            Core::ScarcityCounts counts = Core::CountAuctions(rows, true);
+            times.push_back(SecondsSince(t0));
+            r.scarcityKeys = counts.size();
+        }
+        r.scarcitySec = Median(times);
+
+        // Buy planner: BuildPlan over every row (maxScanRows = auctions, no budget limit), as
+        // BuyEngine::BuildPlan runs it with bot owners from the profile and 120 online. Counts,
+        // the source's id index and a fresh planner are set up outside the timed region.
+        Core::BuyScanRules rules;
+        rules.enabled = true;
+        rules.maxScanRows = auctions;
+        rules.budgetCopper = UINT64_MAX / 2;
+        rules.ownerAlliance = p.botOwners[0];
+        rules.ownerHorde = p.botOwners[1];
+        rules.ownerNeutral = p.botOwners[2];
+
+        Stub::CountedScarcity scarcity;
+        {
+            std::vector<Core::AuctionFacts> rows;
+            source.Snapshot(rows);
+            scarcity.Recount(rows);
+        }
+        scarcity.SetOnlineCount(120);
+        source.Index();
+
+        times.clear();
+        for (uint32_t rep = 0; rep < opt.reps; ++rep)
+        {
+            Stub::RecordingSink sink;
+            Core::BuyPlanner planner(rules, catalog, sink);
+            Core::DefaultBuyPolicy policy{scarcity, 120, rules.minPriceCopper};
+            t0 = Clock::now();
+            planner.BuildPlan(source, policy);
+            times.push_back(SecondsSince(t0));
+            r.buyScanned = planner.Stats().scanned;
+            r.buyAccepted = planner.Stats().accepted;
+        }
+        r.buySec = Median(times);
+
+        r.peakRssKb = PeakRssKb();
+        return r;
+    }
+
+    double PerSec(double rows, double sec)
+    {
+        return sec > 0 ? rows / sec : 0.0;
+    }
+
+    void WriteJson(std::ostream &os, Options const &opt, std::vector<SizeResult> const &results)
+    {
+        Stub::LoadProfile const &p = opt.profile;
+        char buf[1024];
+        std::snprintf(buf, sizeof(buf),
+                      "{\n  \"tool\": \"dah_loadgen\",\n  \"seed\": %u,\n  \"reps\": %u,\n"
+                      "  \"profile\": {\"items\": %u, \"skew\": %.3f, \"stack\": [%u, %u], \"full_stack\": %.3f, "
+                      "\"spread\": [%.3f, %.3f], \"houses\": [%.3f, %.3f, %.3f], \"bots\": %.3f},\n  \"results\": [",
+                      p.seed, opt.reps, p.items, p.itemSkew, p.stackMin, p.stackMax, p.fullStackShare,
+                      p.spreadMin, p.spreadMax, p.houseSplit[0], p.houseSplit[1], p.houseSplit[2], p.botShare);
+        os << buf;
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            SizeResult const &r = results[i];
+            std::snprintf(buf, sizeof(buf),
+                          "%s\n    {\"auctions\": %u, \"generate_s\": %.4f, "
+                          "\"scarcity\": {\"covers\": \"snapshot + Core::CountAuctions\", \"s\": %.4f, \"rows_per_s\": %.0f, \"keys\": %zu}, "
+                          "\"buy_build_plan\": {\"covers\": \"Core::BuyPlanner::BuildPlan (BuyEngine::BuildPlan)\", \"s\": %.4f, "
+                          "\"rows_per_s\": %.0f, \"scanned\": %u, \"accepted\": %u}, "
+                          "\"rss_after_generate_kb\": %llu, \"peak_rss_kb\": %llu, \"peak_is_per_size\": %s}",
+                          i ? "," : "", r.auctions, r.genSec,
+                          r.scarcitySec, PerSec(r.auctions, r.scarcitySec), r.scarcityKeys,
+                          r.buySec, PerSec(r.buyScanned, r.buySec), r.buyScanned, r.buyAccepted,
+                          (unsigned long long)r.baseRssKb, (unsigned long long)r.peakRssKb, r.peakReset ? "true" : "false");
+            os << buf;
+        }
+        os << "\n  ]\n}\n";
+    }
+
+    template <typename T>
+    bool ParseList(char const *s, std::vector<T> &out)
+    {
+        out.clear();
+        std::stringstream ss(s);
+        std::string tok;
+        while (std::getline(ss, tok, ','))
+            out.push_back(T(std::strtod(tok.c_str(), nullptr)));
+        return !out.empty();
+    }
+
+    bool ParseRange(char const *s, double &lo, double &hi)
+    {
+        char *end = nullptr;
+        lo = std::strtod(s, &end);
+        if (!end || *end != '-')
+            return false;
+        hi = std::strtod(end + 1, nullptr);
+        return lo <= hi;
+    }
+
+    bool ParseArgs(int argc, char **argv, Options &opt)
+    {
+        Stub::LoadProfile &p = opt.profile;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string a = argv[i];
+            if (i + 1 >= argc)
+                return false;
+            char const *val = argv[++i];
+            if (a == "--auctions")
+            {
+                if (!ParseList(val, opt.sizes))
+                    return false;
+            }
+            else if (a == "--items")
+                p.items = std::max(1u, uint32_t(std::strtoul(val, nullptr, 10)));
+            else if (a == "--skew")
+                p.itemSkew = std::strtod(val, nullptr);
+            else if (a == "--stack")
+            {
+                double lo, hi;
+                if (!ParseRange(val, lo, hi))
+                    return false;
+                p.stackMin = uint32_t(std::max(1.0, lo));
+                p.stackMax = uint32_t(std::max(1.0, hi));
+            }
+            else if (a == "--full-stack")
+                p.fullStackShare = std::strtod(val, nullptr);
+            else if (a == "--spread")
+            {
+                if (!ParseRange(val, p.spreadMin, p.spreadMax))
+                    return false;
+            }
+            else if (a == "--houses")
+            {
+                std::vector<double> w;
+                if (!ParseList(val, w) || w.size() != 3)
+                    return false;
+                std::copy(w.begin(), w.end(), p.houseSplit.begin());
+            }
+            else if (a == "--bots")
+                p.botShare = std::strtod(val, nullptr);
+            else if (a == "--seed")
+                p.seed = uint32_t(std::strtoul(val, nullptr, 10));
+            else if (a == "--reps")
+                opt.reps = std::max(1u, uint32_t(std::strtoul(val, nullptr, 10)));
+            else if (a == "--out")
+                opt.out = val;
+            else
+                return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options opt;
+    if (!ParseArgs(argc, argv, opt))
+    {
+        std::fprintf(stderr,
+                     "usage: %s [--auctions N,N,...] [--items N] [--skew X] [--stack LO-HI] [--full-stack F]\n"
+                     "          [--spread LO-HI] [--houses A,H,N] [--bots F] [--seed N] [--reps N] [--out file]\n",
+                     argv[0]);
+        return 2;
+    }
+
+    std::vector<SizeResult> results;
+    for (uint32_t n : opt.sizes)
+    {
+        SizeResult r = RunSize(opt, n);
+        std::fprintf(stderr,
+                     "auctions=%-7u gen %.2fs | scarcity %10.0f rows/s (%zu keys) | buy plan %10.0f rows/s (%u accepted) "
+                     "| peak %.1f MiB%s\n",
+                     r.auctions, r.genSec, PerSec(r.auctions, r.scarcitySec), r.scarcityKeys,
+                     PerSec(r.buyScanned, r.buySec), r.buyAccepted, double(r.peakRssKb) / 1024.0,
+                     r.peakReset ? "" : " (process peak)");
+        results.push_back(r);
+    }
+
+    if (opt.out.empty())
+        WriteJson(std::cout, opt, results);
+    else
+    {
+        std::ofstream f(opt.out);
+        if (!f)
+        {
+            std::fprintf(stderr, "cannot write %s\n", opt.out.c_str());
+            return 1;
+        }
+        WriteJson(f, opt, results);
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include "StubCore.h"
+
+#include <algorithm>
+
+namespace ModDynamicAH
+{
+    namespace Stub
+    {
+
+        // position in the scan order (Core::Houses)
+        static size_t HouseSlot(Core::House house)
+        {
+            return house == Core::House::Alliance ? 0 : house == Core::House::Horde ? 1 : 2;
+        }
+
+        VectorItemCatalog::VectorItemCatalog(std::vector<Core::ItemFacts> items)
+        {
+            for (Core::ItemFacts const &item : items)
+                Put(item);
+        }
+
+        void VectorItemCatalog::Put(Core::ItemFacts const &item)
+        {
+            ++_generation;
+            if (item.itemId >= _indexOf.size())
+                _indexOf.resize(size_t(item.itemId) + 1, NoIndex);
+
+            if (_indexOf[item.itemId] != NoIndex)
+            {
+                _items[_indexOf[item.itemId]] = item;
+                return;
+            }
+
+            // keep ascending id order; appends are the common case
+            auto it = std::lower_bound(_items.begin(), _items.end(), item.itemId,
+                                       [](Core::ItemFacts const &a, uint32_t id)
+                                       { return a.itemId < id; });
+            bool append = it == _items.end();
+            it = _items.insert(it, item);
+            if (append)
+            {
+                _indexOf[item.itemId] = uint32_t(_items.size() - 1);
+                return;
+            }
+            for (size_t i = size_t(it - _items.begin()); i < _items.size(); ++i)
+                _indexOf[_items[i].itemId] = uint32_t(i);
+        }
+
+        Core::ItemFacts const *VectorItemCatalog::Find(uint32_t itemId) const
+        {
+            if (itemId >= _indexOf.size() || _indexOf[itemId] == NoIndex)
+                return nullptr;
+            return &_items[_indexOf[itemId]];
+        }
+
+        void VectorItemCatalog::ForEach(std::function<void(Core::ItemFacts const &)> const &fn) const
+        {
+            for (Core::ItemFacts const &item : _items)
+                fn(item);
+        }
+
+        void VectorAuctionSource::Snapshot(std::vector<Core::AuctionFacts> &out)
+        {
+            out.clear();
+            out.reserve(_rows.size());
+            for (Core::House house : Core::Houses)
+                for (Core::AuctionFacts const &row : _rows)
+                    if (row.house == house)
+                        out.push_back(row);
+        }
+
+        void VectorAuctionSource::Index()
+        {
+            for (std::vector<uint32_t> &ids : _byHouse)
+                ids.clear();
+            for (size_t i = 0; i < _rows.size(); ++i)
+                _byHouse[HouseSlot(_rows[i].house)].push_back(uint32_t(i));
+            for (std::vector<uint32_t> &ids : _byHouse)
+                std::sort(ids.begin(), ids.end(), [this](uint32_t a, uint32_t b)
+                          { return _rows[a].id < _rows[b].id; });
+            _indexed = true;
+        }
+
+        size_t VectorAuctionSource::ScanHouse(Core::House house, uint32_t afterId, size_t maxRows,
+                                              std::vector<Core::AuctionFacts> &out)
+        {
+            if (!_indexed)
+                Index();
+
+            std::vector<uint32_t> const &ids = _byHouse[HouseSlot(house)];
+            auto it = std::upper_bound(ids.begin(), ids.end(), afterId, [this](uint32_t id, uint32_t i)
+                                       { return id < _rows[i].id; });
+            size_t n = 0;
+            for (; it != ids.end() && n < maxRows; ++it, ++n)
+                out.push_back(_rows[*it]);
+            return n;
+        }
+
+    } // namespace Stub
+} // namespace ModDynamicAH
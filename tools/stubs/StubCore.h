@@ -0,0 +1,121 @@
+#pragma once
+
+// In-memory implementations of the core interfaces, for driving src/core without a
+// worldserver (tools/, profiling). Nothing here touches AzerothCore.
+
+#include "CoreInterfaces.h"
+#include "CoreScarcity.h"
+
+#include <vector>
+
+namespace ModDynamicAH
+{
+    namespace Stub
+    {
+
+        // Items held in a vector, looked up through a flat item id -> index array
+        class VectorItemCatalog final : public Core::IItemCatalog
+        {
+        public:
+            VectorItemCatalog() = default;
+            explicit VectorItemCatalog(std::vector<Core::ItemFacts> items);
+
+            // Adds or replaces an item (a new generation)
+            void Put(Core::ItemFacts const &item);
+            size_t Size() const { return _items.size(); }
+
+            Core::ItemFacts const *Find(uint32_t itemId) const override;
+            void ForEach(std::function<void(Core::ItemFacts const &)> const &fn) const override;
+            uint32_t Generation() const override { return _generation; }
+
+        private:
+            static constexpr uint32_t NoIndex = UINT32_MAX;
+
+            std::vector<Core::ItemFacts> _items; // ascending item id
+            std::vector<uint32_t> _indexOf;      // item id -> index into _items
+            uint32_t _generation = 1;
+        };
+
+        // Auctions held in a vector; Snapshot copies them in house order, ScanHouse walks a
+        // per-house id index built on first use after a change
+        class VectorAuctionSource final : public Core::IAuctionSource
+        {
+        public:
+            void Add(Core::AuctionFacts const &row)
+            {
+                _rows.push_back(row);
+                _indexed = false;
+            }
+            void Clear()
+            {
+                _rows.clear();
+                _indexed = false;
+            }
+            void Reserve(size_t n) { _rows.reserve(n); }
+            size_t Size() const { return _rows.size(); }
+            std::vector<Core::AuctionFacts> const &Rows() const { return _rows; }
+
+            void Snapshot(std::vector<Core::AuctionFacts> &out) override;
+            size_t ScanHouse(Core::House house, uint32_t afterId, size_t maxRows, std::vector<Core::AuctionFacts> &out) override;
+            // Builds the per-house id index now rather than on the first ScanHouse
+            void Index();
+
+        private:
+
+            std::vector<Core::AuctionFacts> _rows;
+            std::vector<uint32_t> _byHouse[3]; // indices into _rows, ascending auction id
+            bool _indexed = false;
+        };
+
+        // Active counts tallied from a snapshot, as the in-memory scarcity rebuild does
+        class CountedScarcity final : public Core::IScarcitySource
+        {
+        public:
+            void Recount(std::vector<Core::AuctionFacts> const &rows) { _counts = Core::CountAuctions(rows, false); }
+            void SetOnlineCount(uint32_t online) { _online = online; }
+
+            uint32_t ActiveCount(uint32_t itemId, Core::House house) const override
+            {
+                return Core::ActiveCount(_counts, house, itemId);
+            }
+            uint32_t OnlineCount() const override { return _online; }
+
+        private:
+            Core::ScarcityCounts _counts;
+            uint32_t _online = 0;
+        };
+
+        // Time only moves when told to
+        class ManualClock final : public Core::IClock
+        {
+        public:
+            explicit ManualClock(uint64_t nowMs = 0) : _nowMs(nowMs) {}
+
+            void Advance(uint64_t ms) { _nowMs += ms; }
+            void Set(uint64_t ms) { _nowMs = ms; }
+
+            uint64_t NowMs() const override { return _nowMs; }
+            uint32_t NowSec() const override { return uint32_t(_nowMs / 1000); }
+
+        private:
+            uint64_t _nowMs;
+        };
+
+        // Keeps every decision it receives
+        class RecordingSink final : public Core::IPersistenceSink
+        {
+        public:
+            void Post(Core::PostDecision const &d) override { posts.push_back(d); }
+            void Buy(Core::BuyDecision const &d) override { buys.push_back(d); }
+            void Clear()
+            {
+                posts.clear();
+                buys.clear();
+            }
+
+            std::vector<Core::PostDecision> posts;
+            std::vector<Core::BuyDecision> buys;
+        };
+
+    } // namespace Stub
+} // namespace ModDynamicAH
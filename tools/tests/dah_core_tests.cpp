@@ -0,0 +1,800 @@
+// dah_core_tests: unit tests of the decision core (src/core) driven through tools/stubs.
+//
+//   dah_core_tests [name]
+//
+// Runs every case, or only the one named; exits non-zero when a check fails. ctest registers
+// each case as its own test.
+
+#include "CoreBuy.h"
+#include "CoreBuyPlanner.h"
+#include "CoreMaterials.h"
+#include "CorePricing.h"
+#include "CoreScarcity.h"
+#include "CoreSelection.h"
+#include "CoreSellPlanner.h"
+#include "StubCore.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <set>
+#include <vector>
+
+using namespace ModDynamicAH;
+
+namespace
+{
+    int g_failures = 0;
+
+    void Check(bool ok, char const *expr, int line)
+    {
+        if (ok)
+            return;
+        std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, line, expr);
+        ++g_failures;
+    }
+
+    void CheckEq(uint64_t a, uint64_t b, char const *expr, int line)
+    {
+        if (a == b)
+            return;
+        std::fprintf(stderr, "%s:%d: CHECK_EQ(%s) failed: %llu != %llu\n", __FILE__, line, expr,
+                     (unsigned long long)a, (unsigned long long)b);
+        ++g_failures;
+    }
+
+#define CHECK(cond) Check(bool(cond), #cond, __LINE__)
+#define CHECK_EQ(a, b) CheckEq(uint64_t(a), uint64_t(b), #a ", " #b, __LINE__)
+
+    // --- pricing --------------------------------------------------------------------------------
+
+    void TestComputeUnit()
+    {
+        // vendor base below the min price: the min price is the baseline
+        Core::PricingResult r = Core::ComputeUnit(500, 0, 0, 10000);
+        CHECK_EQ(r.startBid, 12500u); // 10000 * 1.25 (no supply), no population bonus
+        CHECK_EQ(r.buyout, 18125u);   // * 1.45
+
+        // more supply -> cheaper, more players -> dearer
+        Core::PricingResult scarce = Core::ComputeUnit(20000, 1, 100, 100);
+        Core::PricingResult plenty = Core::ComputeUnit(20000, 9, 100, 100);
+        Core::PricingResult crowded = Core::ComputeUnit(20000, 9, 1000, 100);
+        CHECK(scarce.startBid > plenty.startBid);
+        CHECK(crowded.startBid > plenty.startBid);
+
+        // the population bonus stops at +30%
+        CHECK_EQ(Core::ComputeUnit(20000, 0, 1500, 100).startBid, Core::ComputeUnit(20000, 0, 5000, 100).startBid);
+
+        // buyout always above the start bid, start bid never below the min price
+        Core::PricingResult tiny = Core::ComputeUnit(0, 1000, 0, 1);
+        CHECK(tiny.startBid >= 1u);
+        CHECK(tiny.buyout > tiny.startBid);
+
+        CHECK_EQ(Core::VendorBase(300, 1000), 500u);
+        CHECK_EQ(Core::VendorBase(700, 1000), 700u);
+    }
+
+    void TestComputeBatch()
+    {
+        std::vector<uint32_t> vendorBase = {0, 500, 20000, 20000, 123456};
+        std::vector<uint32_t> active = {0, 0, 1, 9, 40};
+        std::vector<uint32_t> minPrice = {10000, 10000, 100, 100, 100};
+        size_t n = vendorBase.size();
+        std::vector<uint32_t> start(n), buyout(n);
+
+        Core::PricingBatch b;
+        b.n = n;
+        b.vendorBase = vendorBase.data();
+        b.active = active.data();
+        b.minPrice = minPrice.data();
+        b.onlineCount = 250;
+        b.outStart = start.data();
+        b.outBuyout = buyout.data();
+        Core::ComputeBatch(b);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            Core::PricingResult r = Core::ComputeUnit(vendorBase[i], active[i], b.onlineCount, minPrice[i]);
+            CHECK_EQ(start[i], r.startBid);
+            CHECK_EQ(buyout[i], r.buyout);
+        }
+
+        // an empty batch touches nothing
+        Core::PricingBatch empty;
+        Core::ComputeBatch(empty);
+    }
+
+    // ComputeBatch against ComputeUnit over a grid: no supply and growing supply, populations on
+    // both sides of the +30% cap (reached at 1500 online), min prices above and below the vendor base
+    void TestBatchMatchesUnit()
+    {
+        uint32_t const vendorBases[] = {0, 1, 99, 500, 10000, 123457, 4000000};
+        uint32_t const actives[] = {0, 1, 2, 3, 7, 50, 1000};
+        uint32_t const minPrices[] = {1, 100, 10000, 250000};
+        uint32_t const onlines[] = {0, 1, 250, 499, 500, 1499, 1500, 1501, 5000};
+
+        std::vector<uint32_t> vendorBase, active, minPrice;
+        for (uint32_t vb : vendorBases)
+            for (uint32_t act : actives)
+                for (uint32_t mp : minPrices)
+                {
+                    vendorBase.push_back(vb);
+                    active.push_back(act);
+                    minPrice.push_back(mp);
+                }
+        size_t n = vendorBase.size();
+
+        size_t minAboveBase = 0;
+        for (size_t i = 0; i < n; ++i)
+            minAboveBase += minPrice[i] > vendorBase[i];
+        CHECK(minAboveBase > 0 && minAboveBase < n);
+
+        for (uint32_t online : onlines)
+        {
+            std::vector<uint32_t> start(n), buyout(n);
+            Core::PricingBatch b;
+            b.n = n;
+            b.vendorBase = vendorBase.data();
+            b.active = active.data();
+            b.minPrice = minPrice.data();
+            b.onlineCount = online;
+            b.outStart = start.data();
+            b.outBuyout = buyout.data();
+            Core::ComputeBatch(b);
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                Core::PricingResult r = Core::ComputeUnit(vendorBase[i], active[i], online, minPrice[i]);
+                if (start[i] != r.startBid || buyout[i] != r.buyout)
+                    std::fprintf(stderr, "  vendorBase=%u active=%u minPrice=%u online=%u\n", vendorBase[i],
+                                 active[i], minPrice[i], online);
+                CHECK_EQ(start[i], r.startBid);
+                CHECK_EQ(buyout[i], r.buyout);
+            }
+        }
+    }
+
+    // --- buying ---------------------------------------------------------------------------------
+
+    Core::BuyRules Rules()
+    {
+        Core::BuyRules rules;
+        rules.budgetCopper = 100000;
+        rules.minMargin = 0.15f;
+        rules.perItemPerCycleCap = 2;
+        rules.ownerAlliance = 11;
+        rules.ownerHorde = 12;
+        return rules;
+    }
+
+    Core::AuctionFacts Row(uint32_t itemId, uint32_t count, uint32_t buyout)
+    {
+        Core::AuctionFacts row;
+        row.id = itemId * 10;
+        row.house = Core::House::Alliance;
+        row.itemId = itemId;
+        row.count = count;
+        row.startBid = buyout / 2;
+        row.buyout = buyout;
+        row.owner = 99;
+        return row;
+    }
+
+    void TestRowVerdict()
+    {
+        Core::BuyRules rules = Rules();
+
+        Core::AuctionFacts row = Row(1, 1, 1000);
+        CHECK(Core::RowVerdict(rules, row) == Core::BuyReason::Accepted);
+
+        Core::AuctionFacts noBuyout = row;
+        noBuyout.buyout = 0;
+        CHECK(Core::RowVerdict(rules, noBuyout) == Core::BuyReason::NoBuyout);
+
+        Core::AuctionFacts bid = row;
+        bid.hasBidder = true;
+        CHECK(Core::RowVerdict(rules, bid) == Core::BuyReason::HasBidder);
+
+        Core::AuctionFacts own = row;
+        own.owner = 12;
+        CHECK(Core::RowVerdict(rules, own) == Core::BuyReason::OwnAuction);
+
+        // an unset bot owner (0) never matches an ownerless row
+        own.owner = 0;
+        CHECK(Core::RowVerdict(rules, own) == Core::BuyReason::Accepted);
+    }
+
+    void TestQualityAllowed()
+    {
+        Core::BuyRules rules = Rules();
+        Core::BuyQualityFilter filter;
+        filter.whiteAllow.insert(5);
+
+        Stub::VectorItemCatalog catalog;
+        catalog.Put({4, Core::QualityNormal, 2, 1, 100, 0});
+        catalog.Put({5, Core::QualityNormal, 2, 1, 100, 0});
+        catalog.Put({6, Core::QualityNormal, Core::ItemClassTradeGoods, 20, 100, 0});
+        catalog.Put({7, 2, 2, 1, 100, 0});
+        catalog.Put({8, 5, 2, 1, 100, 0});
+
+        CHECK(!Core::QualityAllowed(rules, filter, *catalog.Find(4))); // common, blocked
+        CHECK(Core::QualityAllowed(rules, filter, *catalog.Find(5)));  // common, allow-listed
+        CHECK(Core::QualityAllowed(rules, filter, *catalog.Find(6)));  // trade goods
+        CHECK(Core::QualityAllowed(rules, filter, *catalog.Find(7)));  // uncommon
+        CHECK(!Core::QualityAllowed(rules, filter, *catalog.Find(8))); // legendary, off by default
+    }
+
+    void TestDecideBuy()
+    {
+        Core::BuyRules rules = Rules();
+        Core::PricingResult fair{800, 1000}; // fair unit buyout 1000
+
+        // margin: 20% under fair passes, 10% under does not
+        {
+            Core::BuyLedger ledger;
+            Core::BuyVerdict v = Core::DecideBuy(rules, ledger, Row(1, 2, 1600), fair, 0, 0);
+            CHECK(v.reason == Core::BuyReason::Accepted);
+            CHECK_EQ(v.fairStack, 2000u);
+            CHECK_EQ(v.unitBuyout, 800u);
+            CHECK_EQ(ledger.budgetUsed, 1600u);
+            CHECK_EQ(ledger.perItem[1], 1u);
+
+            v = Core::DecideBuy(rules, ledger, Row(2, 2, 1800), fair, 0, 0);
+            CHECK(v.reason == Core::BuyReason::Margin);
+            CHECK_EQ(ledger.budgetUsed, 1600u); // rejections charge nothing
+        }
+
+        // no fair buyout: falls back to max(min price, 2x vendor sell)
+        {
+            Core::BuyLedger ledger;
+            Core::BuyVerdict v = Core::DecideBuy(rules, ledger, Row(1, 1, 8000), Core::PricingResult{}, 0, 100);
+            CHECK_EQ(v.fairUnit, rules.minPriceCopper);
+            CHECK(v.reason == Core::BuyReason::Accepted);
+        }
+
+        // per-item cap: the third buy of one item in a cycle is refused, other items still pass
+        {
+            Core::BuyLedger ledger;
+            CHECK(Core::DecideBuy(rules, ledger, Row(1, 1, 500), fair, 0, 0).reason == Core::BuyReason::Accepted);
+            CHECK(Core::DecideBuy(rules, ledger, Row(1, 1, 500), fair, 0, 0).reason == Core::BuyReason::Accepted);
+            CHECK(Core::DecideBuy(rules, ledger, Row(1, 1, 500), fair, 0, 0).reason == Core::BuyReason::PerItemCap);
+            CHECK(Core::DecideBuy(rules, ledger, Row(2, 1, 500), fair, 0, 0).reason == Core::BuyReason::Accepted);
+            CHECK_EQ(ledger.budgetUsed, 1500u);
+
+            ledger.Reset();
+            CHECK(Core::DecideBuy(rules, ledger, Row(1, 1, 500), fair, 0, 0).reason == Core::BuyReason::Accepted);
+        }
+
+        // budget: a buy that would overrun it is refused, a smaller one still fits
+        {
+            Core::BuyRules tight = rules;
+            tight.budgetCopper = 1000;
+            Core::BuyLedger ledger;
+            CHECK(Core::DecideBuy(tight, ledger, Row(1, 1, 700), fair, 0, 0).reason == Core::BuyReason::Accepted);
+            CHECK(Core::DecideBuy(tight, ledger, Row(2, 1, 400), fair, 0, 0).reason == Core::BuyReason::Budget);
+            CHECK(Core::DecideBuy(tight, ledger, Row(3, 1, 300), fair, 0, 0).reason == Core::BuyReason::Accepted);
+            CHECK_EQ(ledger.budgetUsed, 1000u);
+        }
+
+        // vendor safety: never pay more per unit than the vendor asks
+        {
+            Core::BuyLedger ledger;
+            CHECK(!Core::PassesVendorSafety(rules, 601, 600));
+            CHECK(Core::PassesVendorSafety(rules, 600, 600));
+            CHECK(Core::PassesVendorSafety(rules, 601, 0)); // not vendor-sold
+
+            Core::BuyVerdict v = Core::DecideBuy(rules, ledger, Row(1, 2, 1400), fair, 600, 0);
+            CHECK(v.reason == Core::BuyReason::VendorSafety);
+            CHECK_EQ(ledger.budgetUsed, 0u);
+
+            Core::BuyRules lax = rules;
+            lax.neverAboveVendorBuyPrice = false;
+            CHECK(Core::DecideBuy(lax, ledger, Row(1, 2, 1400), fair, 600, 0).reason == Core::BuyReason::Accepted);
+        }
+    }
+
+    // --- selection ------------------------------------------------------------------------------
+
+    void TestSampleIndices()
+    {
+        std::vector<size_t> a = Core::SampleIndices(100000, 500, 7);
+        std::vector<size_t> b = Core::SampleIndices(100000, 500, 7);
+        std::vector<size_t> c = Core::SampleIndices(100000, 500, 8);
+        CHECK(a == b);
+        CHECK(a != c);
+        CHECK_EQ(a.size(), size_t(500));
+
+        std::set<size_t> distinct(a.begin(), a.end());
+        CHECK_EQ(distinct.size(), a.size());
+        CHECK(*distinct.rbegin() < 100000u);
+
+        // k >= n draws a permutation of the whole range
+        std::vector<size_t> all = Core::SampleIndices(10, 25, 3);
+        CHECK_EQ(all.size(), size_t(10));
+        std::sort(all.begin(), all.end());
+        for (size_t i = 0; i < all.size(); ++i)
+            CHECK_EQ(all[i], i);
+
+        CHECK(Core::SampleIndices(0, 5, 1).empty());
+        CHECK(Core::SampleIndices(5, 0, 1).empty());
+    }
+
+    // --- scarcity -------------------------------------------------------------------------------
+
+    void TestCountAuctions()
+    {
+        Stub::VectorAuctionSource source;
+        auto add = [&](Core::House house, uint32_t itemId, uint32_t count)
+        {
+            Core::AuctionFacts row;
+            row.id = uint32_t(source.Size() + 1);
+            row.house = house;
+            row.itemId = itemId;
+            row.count = count;
+            source.Add(row);
+        };
+        add(Core::House::Horde, 1, 5);
+        add(Core::House::Alliance, 1, 20);
+        add(Core::House::Alliance, 1, 0); // a zero count still counts one unit
+        add(Core::House::Neutral, 2, 1);
+        add(Core::House::Alliance, 3, 4);
+
+        std::vector<Core::AuctionFacts> rows;
+        source.Snapshot(rows);
+        CHECK_EQ(rows.size(), size_t(5));
+
+        Core::ScarcityCounts units = Core::CountAuctions(rows, true);
+        CHECK_EQ(units.size(), size_t(4));
+        CHECK_EQ(Core::ActiveCount(units, Core::House::Alliance, 1), 2u);
+        CHECK_EQ(units[Core::ScarcityKey(Core::House::Alliance, 1)].units, 21u);
+        CHECK_EQ(Core::ActiveCount(units, Core::House::Horde, 1), 1u);
+        CHECK_EQ(units[Core::ScarcityKey(Core::House::Horde, 1)].units, 5u);
+        CHECK_EQ(Core::ActiveCount(units, Core::House::Neutral, 2), 1u);
+        CHECK_EQ(Core::ActiveCount(units, Core::House::Horde, 2), 0u);
+        CHECK_EQ(Core::ActiveCount(units, Core::House::Alliance, 99), 0u);
+
+        Core::ScarcityCounts auctions = Core::CountAuctions(rows, false);
+        CHECK_EQ(Core::ActiveCount(auctions, Core::House::Alliance, 1), 2u);
+        CHECK_EQ(auctions[Core::ScarcityKey(Core::House::Alliance, 1)].units, 0u);
+
+        CHECK(Core::CountAuctions({}, true).empty());
+    }
+
+    // --- sell planner (DynamicAHPlanner runs it over the item index) -----------------------------
+
+    Core::ItemFacts Item(uint32_t itemId, uint32_t sellPrice, uint32_t buyPrice = 0, uint16_t stackable = 20)
+    {
+        Core::ItemFacts item;
+        item.itemId = itemId;
+        item.quality = 2;
+        item.itemClass = Core::ItemClassTradeGoods;
+        item.stackable = stackable;
+        item.sellPrice = sellPrice;
+        item.buyPrice = buyPrice;
+        return item;
+    }
+
+    struct SellFixture
+    {
+        Stub::VectorItemCatalog catalog;
+        Stub::CountedScarcity scarcity;
+        Stub::ManualClock clock{1700000000000ull};
+        Stub::RecordingSink sink;
+        Core::SellPlanner planner{catalog, scarcity, clock, sink};
+    };
+
+    bool SamePosts(std::vector<Core::PostDecision> const &a, std::vector<Core::PostDecision> const &b)
+    {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](Core::PostDecision const &x, Core::PostDecision const &y)
+                          { return x.house == y.house && x.itemId == y.itemId && x.count == y.count &&
+                                   x.startBid == y.startBid && x.buyout == y.buyout && x.lane == y.lane; });
+    }
+
+    void TestPriceWithPolicies()
+    {
+        SellFixture f;
+        Core::SellRules rules;
+        rules.contextEnabled = false;
+
+        Core::ItemFacts plain = Item(10, 4000);
+        Core::ItemFacts shard = Item(11, 4000);
+        shard.category = Core::MatCategory::Shard;
+        Core::ItemFacts vendor = Item(12, 100, 50000);
+        Core::ItemFacts mat = Item(13, 10);
+        mat.recipeEff = 20;
+        mat.recipeMax = 60;
+        for (Core::ItemFacts const &item : {plain, shard, vendor, mat})
+            f.catalog.Put(item);
+
+        Core::AuctionFacts a1, a2;
+        a1.id = 1;
+        a2.id = 2;
+        a1.house = a2.house = Core::House::Alliance;
+        a1.itemId = a2.itemId = 10;
+        f.scarcity.Recount({a1, a2});
+        f.scarcity.SetOnlineCount(120);
+        f.planner.BeginContextPlan(rules); // reads the clock (jitter seed)
+
+        auto price = [&](Core::SellRules const &r, Core::Family fam, Core::ItemFacts const &item, Core::House house)
+        {
+            Core::PricingResult out;
+            f.planner.PriceWithPolicies(r, fam, item, house, out.startBid, out.buyout);
+            return out;
+        };
+
+        // the policy chain over the engine price at the current counts
+        for (Core::ItemFacts const &item : {plain, shard, vendor, mat})
+            for (Core::House house : Core::Houses)
+            {
+                Core::Family fam = item.itemId == 13 ? Core::Family::Herb : Core::Family::Other;
+                uint32_t active = f.scarcity.ActiveCount(item.itemId, house);
+                Core::PriceParts parts = Core::PartsFor(rules, fam, item);
+                Core::PricingResult engine = Core::ComputeUnit(parts.vendorBase, active, 120, parts.minPrice);
+                Core::PricingResult want = Core::ApplyPolicies(rules, item, parts, engine, active, f.clock.NowSec());
+                Core::PricingResult got = price(rules, fam, item, house);
+                CHECK_EQ(got.startBid, want.startBid);
+                CHECK_EQ(got.buyout, want.buyout);
+                CHECK(got.buyout >= got.startBid);
+            }
+
+        // fewer auctions up -> dearer
+        CHECK(price(rules, Core::Family::Other, plain, Core::House::Horde).buyout >
+              price(rules, Core::Family::Other, plain, Core::House::Alliance).buyout);
+
+        // category multiplier
+        Core::SellRules flat = rules;
+        flat.mulShard = 1.0;
+        CHECK(price(rules, Core::Family::Other, shard, Core::House::Horde).buyout >
+              price(flat, Core::Family::Other, shard, Core::House::Horde).buyout * 3 / 2);
+
+        // vendor floor: never under the vendor price plus markup
+        Core::PricingResult v = price(rules, Core::Family::Other, vendor, Core::House::Horde);
+        CHECK(v.startBid >= 62500u);
+
+        // recipe ceiling on stackable mats
+        Core::PriceParts matParts = Core::PartsFor(rules, Core::Family::Herb, mat);
+        CHECK(matParts.stackableMat && matParts.recipeUnitCeil > 0);
+        CHECK(price(rules, Core::Family::Herb, mat, Core::House::Horde).buyout <= matParts.recipeUnitCeil);
+
+        // a primed batch gives the same prices, and the parts cache is hit
+        Core::PricingResult before = price(rules, Core::Family::Other, plain, Core::House::Alliance);
+        f.planner.PrimePrices(rules, {Core::PriceKey{Core::Family::Other, 10, Core::House::Alliance}});
+        Core::PricingResult primed = price(rules, Core::Family::Other, plain, Core::House::Alliance);
+        CHECK_EQ(primed.startBid, before.startBid);
+        CHECK_EQ(primed.buyout, before.buyout);
+        CHECK(f.planner.PriceStats().hits > 0);
+    }
+
+    void TestContextPlan()
+    {
+        Core::SellRules rules;
+        auto fill = [](SellFixture &f)
+        {
+            // every context material but the first one
+            for (size_t i = 1; i < Core::CONTEXT_MATS.size(); ++i)
+                f.catalog.Put(Item(Core::CONTEXT_MATS[i].itemId, 500));
+            f.scarcity.SetOnlineCount(40);
+        };
+
+        SellFixture f;
+        fill(f);
+        f.planner.BuildContextPlan(rules);
+        size_t mats = Core::CONTEXT_MATS.size() - 1;
+        CHECK_EQ(f.sink.posts.size(), mats * 2 * rules.stacksMid);
+
+        for (Core::PostDecision const &d : f.sink.posts)
+        {
+            CHECK(d.itemId != Core::CONTEXT_MATS[0].itemId);
+            CHECK(d.house == Core::House::Alliance || d.house == Core::House::Horde);
+            CHECK(d.lane == Core::PostLane::Scarce); // nothing up anywhere
+
+            Core::Family fam = Core::MatFamily(d.itemId);
+            CHECK_EQ(d.count, fam == Core::Family::Shard ? 1u : 20u);
+
+            // stack prices are the unit policy price times the stack
+            Core::PricingResult unit;
+            f.planner.PriceWithPolicies(rules, fam, *f.catalog.Find(d.itemId), d.house, unit.startBid, unit.buyout);
+            CHECK_EQ(d.startBid, unit.startBid * d.count);
+            CHECK_EQ(d.buyout, unit.buyout * d.count);
+        }
+
+        // resumed in slices: the same posts
+        SellFixture g;
+        fill(g);
+        g.planner.BeginContextPlan(rules);
+        size_t steps = 1;
+        while (!g.planner.StepContextPlan(rules, Core::TickBudget(1)))
+            ++steps;
+        CHECK(steps > 1);
+        CHECK(SamePosts(f.sink.posts, g.sink.posts));
+
+        // switched off
+        SellFixture off;
+        fill(off);
+        rules.contextEnabled = false;
+        off.planner.BuildContextPlan(rules);
+        CHECK(off.sink.posts.empty());
+    }
+
+    void TestRandomPlan()
+    {
+        Core::SellRules rules;
+        rules.maxRandomPerCycle = 25;
+        auto fill = [](SellFixture &f)
+        {
+            for (uint32_t id = 1000; id < 1200; ++id)
+                f.catalog.Put(Item(id, 100 + id, 0, uint16_t(id % 4 ? 200 : 1)));
+            for (uint32_t id = 2000; id < 2100; ++id) // commons: not in the pool
+            {
+                Core::ItemFacts common = Item(id, 100);
+                common.quality = Core::QualityNormal;
+                common.itemClass = 2;
+                f.catalog.Put(common);
+            }
+        };
+
+        SellFixture f;
+        fill(f);
+        std::vector<uint32_t> const pool = f.planner.Pool(rules);
+        CHECK_EQ(pool.size(), size_t(200));
+
+        f.planner.BuildRandomPlan(rules);
+        CHECK_EQ(f.sink.posts.size(), size_t(25));
+        std::set<uint32_t> items;
+        for (Core::PostDecision const &d : f.sink.posts)
+        {
+            items.insert(d.itemId);
+            CHECK(d.itemId >= 1000 && d.itemId < 1200);
+            CHECK(d.house == Core::RandomHouseFor(d.itemId));
+            CHECK(d.lane == Core::PostLane::Scarce);
+            CHECK_EQ(d.count, d.itemId % 4 ? 20u : 1u);
+
+            Core::PricingResult unit;
+            f.planner.PriceWithPolicies(rules, Core::Family::Other, *f.catalog.Find(d.itemId), d.house, unit.startBid, unit.buyout);
+            CHECK_EQ(d.startBid, unit.startBid);
+            CHECK_EQ(d.buyout, unit.buyout);
+        }
+        CHECK_EQ(items.size(), size_t(25));
+
+        // the clock seeds the sample: same second, same items; another second, other items
+        SellFixture same;
+        fill(same);
+        same.planner.BuildRandomPlan(rules);
+        CHECK(SamePosts(f.sink.posts, same.sink.posts));
+
+        SellFixture later;
+        fill(later);
+        later.clock.Advance(1000);
+        later.planner.BuildRandomPlan(rules);
+        CHECK(!SamePosts(f.sink.posts, later.sink.posts));
+
+        SellFixture off;
+        fill(off);
+        rules.enableSeller = false;
+        off.planner.BuildRandomPlan(rules);
+        CHECK(off.sink.posts.empty());
+    }
+
+    // --- buy planner (BuyEngine runs it over the live auction houses) ---------------------------
+
+    struct BuyMarket
+    {
+        Stub::VectorItemCatalog catalog;
+        Stub::VectorAuctionSource source;
+        Stub::CountedScarcity scarcity;
+
+        BuyMarket()
+        {
+            for (uint32_t id = 1; id <= 6; ++id)
+                catalog.Put(Item(id, 1000 * id));
+            Core::ItemFacts common = Item(7, 1000);
+            common.quality = Core::QualityNormal;
+            common.itemClass = 2;
+            catalog.Put(common);
+
+            // ids interleaved across the houses; cheap, fair and dear asks
+            uint32_t const asks[] = {2000, 9000, 60000, 4000, 150000};
+            uint32_t next = 100;
+            for (uint32_t round = 0; round < 4; ++round)
+                for (Core::House house : {Core::House::Neutral, Core::House::Horde, Core::House::Alliance})
+                    for (uint32_t itemId = 1; itemId <= 8; ++itemId)
+                    {
+                        Core::AuctionFacts row;
+                        row.id = next--;
+                        row.house = house;
+                        row.itemId = itemId; // 8 is unknown to the catalog
+                        row.count = 1 + (row.id % 3);
+                        row.buyout = asks[(row.id + itemId) % 5] * row.count;
+                        row.startBid = row.buyout / 2;
+                        row.owner = row.id % 11 ? 99 : 11; // a few of the bot's own
+                        row.hasBidder = row.id % 13 == 0;
+                        source.Add(row);
+                    }
+
+            std::vector<Core::AuctionFacts> rows;
+            source.Snapshot(rows);
+            scarcity.Recount(rows);
+            scarcity.SetOnlineCount(50);
+        }
+    };
+
+    Core::BuyScanRules ScanRules()
+    {
+        Core::BuyScanRules rules;
+        static_cast<Core::BuyRules &>(rules) = Rules();
+        rules.budgetCopper = 400000;
+        rules.enabled = true;
+        rules.maxScanRows = 10000;
+        return rules;
+    }
+
+    std::vector<uint32_t> BoughtIds(Stub::RecordingSink const &sink)
+    {
+        std::vector<uint32_t> ids;
+        for (Core::BuyDecision const &d : sink.buys)
+            ids.push_back(d.auctionId);
+        return ids;
+    }
+
+    void TestBuyBuildPlan()
+    {
+        BuyMarket m;
+        Core::BuyScanRules rules = ScanRules();
+        Stub::RecordingSink sink;
+        Core::BuyPlanner planner(rules, m.catalog, sink);
+        Core::DefaultBuyPolicy policy{m.scarcity, 50, rules.minPriceCopper};
+        planner.BuildPlan(m.source, policy);
+        CHECK(planner.Done());
+
+        // the same decisions, row by row, in scan order (house A, H, N; ascending id)
+        std::vector<Core::AuctionFacts> rows;
+        m.source.Snapshot(rows);
+        for (Core::House house : Core::Houses)
+        {
+            auto first = std::find_if(rows.begin(), rows.end(), [&](Core::AuctionFacts const &r)
+                                      { return r.house == house; });
+            auto last = std::find_if(first, rows.end(), [&](Core::AuctionFacts const &r)
+                                     { return r.house != house; });
+            std::sort(first, last, [](Core::AuctionFacts const &a, Core::AuctionFacts const &b)
+                      { return a.id < b.id; });
+        }
+
+        Core::BuyQualityFilter filter;
+        Core::BuyLedger ledger;
+        std::vector<uint32_t> want;
+        uint32_t considered = 0;
+        for (Core::AuctionFacts const &row : rows)
+        {
+            if (Core::RowVerdict(rules, row) != Core::BuyReason::Accepted)
+                continue;
+            Core::ItemFacts const *item = m.catalog.Find(row.itemId);
+            if (!item || !Core::QualityAllowed(rules, filter, *item))
+                continue;
+            ++considered;
+            Core::PricingResult fair = policy.Fair(*item, m.scarcity.ActiveCount(row.itemId, row.house));
+            if (Core::DecideBuy(rules, ledger, row, fair, item->buyPrice, item->sellPrice).reason == Core::BuyReason::Accepted)
+                want.push_back(row.id);
+        }
+
+        CHECK(!want.empty() && want.size() < considered);
+        CHECK(BoughtIds(sink) == want);
+        CHECK_EQ(planner.Stats().scanned, rows.size());
+        CHECK_EQ(planner.Stats().considered, considered);
+        CHECK_EQ(planner.Stats().accepted, want.size());
+        CHECK_EQ(planner.Stats().skipped, rows.size() - want.size());
+        CHECK_EQ(planner.Ledger().budgetUsed, ledger.budgetUsed);
+
+        // the row limit stops the scan
+        rules.maxScanRows = 7;
+        sink.Clear();
+        planner.Ledger().Reset();
+        planner.BuildPlan(m.source, policy);
+        CHECK_EQ(planner.Stats().scanned, 7u);
+
+        // switched off: done without scanning
+        rules.enabled = false;
+        sink.Clear();
+        planner.BuildPlan(m.source, policy);
+        CHECK(planner.Done());
+        CHECK_EQ(planner.Stats().scanned, 0u);
+        CHECK(sink.buys.empty());
+    }
+
+    void TestBuyPlanStepResume()
+    {
+        BuyMarket m;
+        Core::BuyScanRules rules = ScanRules();
+
+        Stub::RecordingSink whole;
+        Core::BuyPlanner once(rules, m.catalog, whole);
+        Core::DefaultBuyPolicy policy{m.scarcity, 50, rules.minPriceCopper};
+        once.BuildPlan(m.source, policy);
+
+        Stub::RecordingSink sliced;
+        Core::BuyPlanner stepped(rules, m.catalog, sliced);
+        stepped.BeginPlan();
+        size_t steps = 1;
+        while (!stepped.PlanStep(m.source, policy, Core::TickBudget(1)))
+            ++steps;
+        CHECK(steps > 1);
+        CHECK(BoughtIds(sliced) == BoughtIds(whole));
+        CHECK_EQ(stepped.Stats().scanned, once.Stats().scanned);
+        CHECK_EQ(stepped.Ledger().budgetUsed, once.Ledger().budgetUsed);
+    }
+
+    // the worker's snapshot path (batched fair prices) decides as the live scan does
+    void TestBuyRowsMatchScan()
+    {
+        BuyMarket m;
+        Core::BuyScanRules rules = ScanRules();
+        Core::DefaultBuyPolicy policy{m.scarcity, 50, rules.minPriceCopper};
+
+        Stub::RecordingSink scanned;
+        Core::BuyPlanner live(rules, m.catalog, scanned);
+        live.BuildPlan(m.source, policy);
+
+        std::vector<Core::AuctionFacts> rows;
+        for (Core::House house : Core::Houses)
+            m.source.ScanHouse(house, 0, SIZE_MAX, rows);
+        Stub::RecordingSink copied;
+        Core::BuyPlanner snap(rules, m.catalog, copied);
+        snap.BuildPlanFromRows(rows, policy);
+
+        CHECK(BoughtIds(copied) == BoughtIds(scanned));
+        CHECK_EQ(snap.Stats().considered, live.Stats().considered);
+        CHECK_EQ(snap.Items(), live.Items());
+    }
+
+#undef CHECK
+#undef CHECK_EQ
+
+    struct Case
+    {
+        char const *name;
+        std::function<void()> run;
+    };
+
+    std::vector<Case> const &Cases()
+    {
+        static std::vector<Case> const cases = {
+            {"pricing.compute_unit", TestComputeUnit},
+            {"pricing.compute_batch", TestComputeBatch},
+            {"pricing.batch_matches_unit", TestBatchMatchesUnit},
+            {"buy.row_verdict", TestRowVerdict},
+            {"buy.quality", TestQualityAllowed},
+            {"buy.decide", TestDecideBuy},
+            {"selection.sample_indices", TestSampleIndices},
+            {"scarcity.count_auctions", TestCountAuctions},
+            {"sell.price_with_policies", TestPriceWithPolicies},
+            {"sell.context_plan", TestContextPlan},
+            {"sell.random_plan", TestRandomPlan},
+            {"buy.build_plan", TestBuyBuildPlan},
+            {"buy.plan_step_resume", TestBuyPlanStepResume},
+            {"buy.rows_match_scan", TestBuyRowsMatchScan},
+        };
+        return cases;
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    char const *only = argc > 1 ? argv[1] : nullptr;
+    size_t ran = 0;
+    for (Case const &c : Cases())
+    {
+        if (only && std::strcmp(only, c.name) != 0)
+            continue;
+        int before = g_failures;
+        c.run();
+        ++ran;
+        std::printf("%-28s %s\n", c.name, g_failures == before ? "ok" : "FAILED");
+    }
+
+    if (!ran)
+    {
+        std::fprintf(stderr, "no test named %s\n", only ? only : "(none)");
+        return 2;
+    }
+    return g_failures ? 1 : 0;
+}